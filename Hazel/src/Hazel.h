@@ -8,6 +8,7 @@
 #include "Hazel/Core/Layer.h"
 #include "Hazel/Core/Log.h"
 #include "Hazel/Core/Assert.h"
+#include "Hazel/Core/JobSystem.h"
 
 #include "Hazel/Core/Timestep.h"
 
@@ -22,6 +23,7 @@
 #include "Hazel/Scene/Entity.h"
 #include "Hazel/Scene/ScriptableEntity.h"
 #include "Hazel/Scene/SceneSerializer.h"
+#include "Hazel/Scene/SceneSnapshot.h"
 #include "Hazel/Scene/Components.h"
 
 // ---Renderer------------------------
@@ -33,6 +35,8 @@
 #include "Hazel/Renderer/Framebuffer.h"
 #include "Hazel/Renderer/Shader.h"
 #include "Hazel/Renderer/Texture.h"
+#include "Hazel/Renderer/SubTexture2D.h"
+#include "Hazel/Renderer/TextureAtlas.h"
 #include "Hazel/Renderer/VertexArray.h"
 
 #include "Hazel/Renderer/OrthographicCamera.h"
@@ -3,6 +3,7 @@
 #include "Hazel/Core/Log.h"
 #include "Hazel/Core/Input.h"
 #include "Hazel/Core/KeyCodes.h"
+#include "Hazel/Core/JobSystem.h"
 #include "Hazel/ImGui/ImGuiLayer.h"
 #include "Hazel/Renderer/Renderer.h"
 #include "Hazel/Renderer/Shader.h"
@@ -32,6 +33,9 @@ namespace Hazel
 		// 绑定执行事件
 		m_Window->SetEventCallback(HZ_BIND_EVENT_FN(&Application::OnEvent));
 
+		// 工作线程在主线程之外执行任务，OpenGL 调用通过 JobAffinity::MainThread 回到主线程
+		JobSystem::Init();
+
 		Renderer::Init();
 
 		// 创建 imgui 图层
@@ -44,6 +48,7 @@ namespace Hazel
 		HZ_PROFILE_FUNCTION();
 
 		Renderer::Shutdown();
+		JobSystem::Shutdown();
 	}
 
 	void Application::Run()
@@ -58,7 +63,9 @@ namespace Hazel
 			Timestep timestep = time - m_LastFrameTime;
 			m_LastFrameTime = time;
 
-			
+			// 执行其他线程提交的主线程任务（如纹理上传）
+			JobSystem::RunMainThreadJobs();
+
 			if (!m_Minimized)
 			{
 				{
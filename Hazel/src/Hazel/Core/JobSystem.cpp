@@ -0,0 +1,283 @@
+#include "hzpch.h"
+#include "Hazel/Core/JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace Hazel {
+
+	struct JobQueue
+	{
+		std::mutex Mutex;
+		std::deque<Job> Jobs;
+	};
+
+	struct JobSystemData
+	{
+		std::thread::id MainThreadID;
+
+		// 0 号队列属于主线程（以及其他非工作线程），1..N 属于工作线程
+		std::vector<Scope<JobQueue>> Queues;
+		std::vector<std::thread> Workers;
+
+		std::mutex MainThreadMutex;
+		std::vector<Job> MainThreadJobs;
+
+		/** 所有队列中尚未开始的任务数，不包括主线程任务 */
+		std::atomic<uint32_t> PendingJobs = 0;
+		std::atomic<uint32_t> SleepingWorkers = 0;
+		std::atomic<bool> Running = false;
+		std::mutex SleepMutex;
+		std::condition_variable WakeCondition;
+	};
+
+	static JobSystemData* s_Data = nullptr;
+	static thread_local uint32_t s_QueueIndex = 0;
+
+	void JobSystem::Init(uint32_t workerCount)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		HZ_CORE_ASSERT(!s_Data, "JobSystem already initialized!");
+
+		if (workerCount == 0)
+			workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+		s_Data = new JobSystemData();
+		s_Data->MainThreadID = std::this_thread::get_id();
+		s_Data->Running = true;
+
+		for (uint32_t i = 0; i <= workerCount; i++)
+			s_Data->Queues.push_back(CreateScope<JobQueue>());
+
+		for (uint32_t i = 1; i <= workerCount; i++)
+			s_Data->Workers.emplace_back(&JobSystem::WorkerLoop, i);
+
+		HZ_CORE_INFO("JobSystem started with {0} worker threads", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		if (!s_Data)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(s_Data->SleepMutex);
+			s_Data->Running = false;
+		}
+		s_Data->WakeCondition.notify_all();
+
+		for (auto& worker : s_Data->Workers)
+			worker.join();
+
+		delete s_Data;
+		s_Data = nullptr;
+	}
+
+	void JobSystem::Schedule(std::function<void()> function, JobCounter* counter, JobCounter* dependency, JobAffinity affinity)
+	{
+		Job job = { std::move(function), counter, affinity };
+
+		// 未初始化时依赖的任务也都已经立即执行完毕
+		if (!s_Data)
+		{
+			job.Function();
+			return;
+		}
+
+		// 在依赖完成之前计数，等待 counter 的线程不会提前返回
+		if (counter)
+			counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+
+		if (dependency)
+		{
+			std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+			if (!dependency->IsDone())
+			{
+				dependency->m_Waiting.push_back(std::move(job));
+				return;
+			}
+		}
+
+		Enqueue(std::move(job));
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		const bool mainThread = IsMainThread();
+		while (!counter.IsDone())
+		{
+			if (mainThread)
+				RunMainThreadJobs();
+
+			if (!s_Data || !TryRunJob(s_QueueIndex))
+				std::this_thread::yield();
+		}
+
+		// 完成最后一个任务的线程在解锁之后才不再访问计数器
+		std::lock_guard<std::mutex> lock(counter.m_Mutex);
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& func)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		if (count == 0)
+			return;
+
+		grainSize = std::max(grainSize, 1u);
+		if (!s_Data || s_Data->Workers.empty() || count <= grainSize)
+		{
+			func(0, count);
+			return;
+		}
+
+		// 函数返回前所有区间都已完成，可以按引用捕获
+		JobCounter counter;
+		for (uint32_t begin = 0; begin < count; begin += grainSize)
+		{
+			uint32_t end = std::min(count - begin, grainSize) + begin;
+			Schedule([&func, begin, end]() { func(begin, end); }, &counter);
+		}
+
+		Wait(counter);
+	}
+
+	void JobSystem::RunMainThreadJobs()
+	{
+		if (!s_Data)
+			return;
+
+		HZ_CORE_ASSERT(IsMainThread(), "Main thread jobs can only run on the main thread!");
+
+		std::vector<Job> jobs;
+		{
+			std::lock_guard<std::mutex> lock(s_Data->MainThreadMutex);
+			if (s_Data->MainThreadJobs.empty())
+				return;
+			jobs.swap(s_Data->MainThreadJobs);
+		}
+
+		for (Job& job : jobs)
+			Execute(job);
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return s_Data ? (uint32_t)s_Data->Workers.size() : 0;
+	}
+
+	bool JobSystem::IsMainThread()
+	{
+		return !s_Data || std::this_thread::get_id() == s_Data->MainThreadID;
+	}
+
+	void JobSystem::Enqueue(Job&& job)
+	{
+		if (job.Affinity == JobAffinity::MainThread)
+		{
+			std::lock_guard<std::mutex> lock(s_Data->MainThreadMutex);
+			s_Data->MainThreadJobs.push_back(std::move(job));
+			return;
+		}
+
+		// 放入当前线程自己的队列，由它按后进先出执行，其他线程空闲时来窃取
+		{
+			JobQueue& queue = *s_Data->Queues[s_QueueIndex];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			queue.Jobs.push_back(std::move(job));
+		}
+		s_Data->PendingJobs.fetch_add(1);
+
+		// 工作线程先增加 SleepingWorkers 再检查 PendingJobs，这里看到 0 时它一定能看到新任务
+		if (s_Data->SleepingWorkers.load() > 0)
+		{
+			{ std::lock_guard<std::mutex> lock(s_Data->SleepMutex); }
+			s_Data->WakeCondition.notify_one();
+		}
+	}
+
+	void JobSystem::Execute(Job& job)
+	{
+		job.Function();
+		if (job.Counter)
+			Complete(job.Counter);
+	}
+
+	void JobSystem::Complete(JobCounter* counter)
+	{
+		std::vector<Job> ready;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_Mutex);
+			if (counter->m_Count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				ready.swap(counter->m_Waiting);
+		}
+
+		for (Job& job : ready)
+			Enqueue(std::move(job));
+	}
+
+	bool JobSystem::TryRunJob(uint32_t queueIndex)
+	{
+		Job job;
+		bool found = false;
+
+		// 自己的队列从队尾取，最近调度的任务数据还在缓存中
+		{
+			JobQueue& queue = *s_Data->Queues[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			if (!queue.Jobs.empty())
+			{
+				job = std::move(queue.Jobs.back());
+				queue.Jobs.pop_back();
+				found = true;
+			}
+		}
+
+		// 从下一个队列开始依次窃取，从队首取走最早调度、通常也是最大的任务
+		const uint32_t queueCount = (uint32_t)s_Data->Queues.size();
+		for (uint32_t i = 1; !found && i < queueCount; i++)
+		{
+			JobQueue& victim = *s_Data->Queues[(queueIndex + i) % queueCount];
+			std::lock_guard<std::mutex> lock(victim.Mutex);
+			if (!victim.Jobs.empty())
+			{
+				job = std::move(victim.Jobs.front());
+				victim.Jobs.pop_front();
+				found = true;
+			}
+		}
+
+		if (!found)
+			return false;
+
+		s_Data->PendingJobs.fetch_sub(1);
+		Execute(job);
+		return true;
+	}
+
+	void JobSystem::WorkerLoop(uint32_t queueIndex)
+	{
+		s_QueueIndex = queueIndex;
+
+		while (true)
+		{
+			if (TryRunJob(queueIndex))
+				continue;
+
+			std::unique_lock<std::mutex> lock(s_Data->SleepMutex);
+			s_Data->SleepingWorkers.fetch_add(1);
+			s_Data->WakeCondition.wait(lock, []() { return s_Data->PendingJobs.load() > 0 || !s_Data->Running; });
+			s_Data->SleepingWorkers.fetch_sub(1);
+
+			if (!s_Data->Running)
+				break;
+		}
+	}
+
+}
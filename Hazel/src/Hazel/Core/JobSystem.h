@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Hazel {
+
+	/** MainThread 的任务只在主线程上执行，用于 OpenGL 等只能在创建上下文的线程上调用的接口 */
+	enum class JobAffinity
+	{
+		Any = 0,
+		MainThread
+	};
+
+	class JobCounter;
+
+	struct Job
+	{
+		std::function<void()> Function;
+		JobCounter* Counter = nullptr;
+		JobAffinity Affinity = JobAffinity::Any;
+	};
+
+	/**
+	* 任务计数器
+	* 关联的任务在调度时加一、完成时减一，归零表示这一组任务全部完成
+	* 也可以作为其他任务的依赖，归零后依赖它的任务才会开始
+	*/
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+	private:
+		std::atomic<uint32_t> m_Count = 0;
+		// 保护 m_Waiting，也保证最后一个任务离开之后 JobSystem::Wait 才返回，调用方可以立即销毁计数器
+		std::mutex m_Mutex;
+		std::vector<Job> m_Waiting;
+
+		friend class JobSystem;
+	};
+
+	/**
+	* 任务系统
+	* 每个工作线程有自己的任务队列，从队尾取出自己调度的任务，空闲时从其他队列的队首窃取；
+	* 主线程同样拥有队列，在 Wait 中参与执行任务。
+	* 未初始化时所有任务都在调用线程上立即执行。
+	*/
+	class JobSystem
+	{
+	public:
+		/** workerCount 为 0 时使用 hardware_concurrency - 1 个工作线程，需要在主线程上调用 */
+		static void Init(uint32_t workerCount = 0);
+		/** 等待工作线程退出，尚未开始的任务被丢弃 */
+		static void Shutdown();
+
+		/**
+		* 调度一个任务
+		* @param counter 可以为空，任务完成时减一
+		* @param dependency 可以为空，计数器归零之后任务才会开始
+		* @param affinity MainThread 的任务在主线程的 RunMainThreadJobs 或 Wait 中执行
+		*/
+		static void Schedule(std::function<void()> function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr, JobAffinity affinity = JobAffinity::Any);
+
+		/** 等待计数器归零，等待期间当前线程也执行队列中的任务 */
+		static void Wait(JobCounter& counter);
+
+		/**
+		* 把 [0, count) 切成 grainSize 大小的区间并行执行 func(begin, end)，全部完成后返回
+		* 只有一个区间或没有工作线程时直接在当前线程执行
+		*/
+		static void ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& func);
+
+		/** 执行排队的主线程任务，Application 每帧调用一次 */
+		static void RunMainThreadJobs();
+
+		static uint32_t GetWorkerCount();
+		static bool IsMainThread();
+	private:
+		static void Enqueue(Job&& job);
+		static void Execute(Job& job);
+		static void Complete(JobCounter* counter);
+		/** 从自己的队列或其他队列取出一个任务执行，没有任务时返回 false */
+		static bool TryRunJob(uint32_t queueIndex);
+		static void WorkerLoop(uint32_t queueIndex);
+	};
+
+}
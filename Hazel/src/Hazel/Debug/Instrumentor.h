@@ -236,9 +236,14 @@ namespace Hazel {
 	#define HZ_PROFILE_SCOPE_LINE(name, line) HZ_PROFILE_SCOPE_LINE2(name, line)
 	#define HZ_PROFILE_SCOPE(name) HZ_PROFILE_SCOPE_LINE(name, __LINE__)
 	#define HZ_PROFILE_FUNCTION() HZ_PROFILE_SCOPE(HZ_FUNC_SIG)
+	// 名字在运行时才确定（如场景系统名），需要在作用域结束前保持有效
+	#define HZ_PROFILE_SCOPE_DYNAMIC_LINE2(name, line) ::Hazel::InstrumentationTimer timer##line(name)
+	#define HZ_PROFILE_SCOPE_DYNAMIC_LINE(name, line) HZ_PROFILE_SCOPE_DYNAMIC_LINE2(name, line)
+	#define HZ_PROFILE_SCOPE_DYNAMIC(name) HZ_PROFILE_SCOPE_DYNAMIC_LINE(name, __LINE__)
 #else
 	#define HZ_PROFILE_BEGIN_SESSION(name, filepath)
 	#define HZ_PROFILE_END_SESSION()
 	#define HZ_PROFILE_SCOPE(name)
 	#define HZ_PROFILE_FUNCTION()
+	#define HZ_PROFILE_SCOPE_DYNAMIC(name)
 #endif
\ No newline at end of file
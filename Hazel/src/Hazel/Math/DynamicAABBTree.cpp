@@ -0,0 +1,346 @@
+#include "hzpch.h"
+#include "DynamicAABBTree.h"
+
+namespace Hazel {
+
+	DynamicAABBTree::DynamicAABBTree(float margin)
+		: m_Margin(margin)
+	{
+	}
+
+	int32_t DynamicAABBTree::CreateProxy(const AABB& box, uint32_t userData)
+	{
+		int32_t proxy = AllocateNode();
+		m_Nodes[proxy].Box = AABB::Expand(box, m_Margin);
+		m_Nodes[proxy].UserData = userData;
+		m_Nodes[proxy].Height = 0;
+
+		InsertLeaf(proxy);
+		m_ProxyCount++;
+		return proxy;
+	}
+
+	void DynamicAABBTree::DestroyProxy(int32_t proxy)
+	{
+		HZ_CORE_ASSERT(proxy >= 0 && proxy < (int32_t)m_Nodes.size() && m_Nodes[proxy].IsLeaf(), "Invalid proxy!");
+
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		m_ProxyCount--;
+	}
+
+	bool DynamicAABBTree::MoveProxy(int32_t proxy, const AABB& box)
+	{
+		HZ_CORE_ASSERT(proxy >= 0 && proxy < (int32_t)m_Nodes.size() && m_Nodes[proxy].IsLeaf(), "Invalid proxy!");
+
+		// 仍在放大后的包围盒内，且放大的包围盒没有大到失去意义（物体缩小后）时不需要重新插入
+		const AABB& fatBox = m_Nodes[proxy].Box;
+		if (fatBox.Contains(box) && AABB::Expand(box, m_Margin * 4.0f).Contains(fatBox))
+			return false;
+
+		RemoveLeaf(proxy);
+		m_Nodes[proxy].Box = AABB::Expand(box, m_Margin);
+		InsertLeaf(proxy);
+		return true;
+	}
+
+	void DynamicAABBTree::Query(const Frustum& frustum, std::vector<uint32_t>& outUserData) const
+	{
+		HZ_PROFILE_FUNCTION();
+
+		if (m_Root == NullNode)
+			return;
+
+		// 栈中用取反的编号标记已知完全在视锥内的子树
+		std::vector<int32_t> stack;
+		stack.reserve(64);
+		stack.push_back(m_Root);
+
+		while (!stack.empty())
+		{
+			int32_t entry = stack.back();
+			stack.pop_back();
+
+			bool inside = entry < 0;
+			const Node& node = m_Nodes[inside ? ~entry : entry];
+
+			if (!inside)
+			{
+				Frustum::Result result = frustum.Test(node.Box);
+				if (result == Frustum::Result::Outside)
+					continue;
+
+				inside = result == Frustum::Result::Inside;
+			}
+
+			if (node.IsLeaf())
+			{
+				outUserData.push_back(node.UserData);
+				continue;
+			}
+
+			stack.push_back(inside ? ~node.Child1 : node.Child1);
+			stack.push_back(inside ? ~node.Child2 : node.Child2);
+		}
+	}
+
+	void DynamicAABBTree::Clear()
+	{
+		m_Nodes.clear();
+		m_Root = NullNode;
+		m_FreeList = NullNode;
+		m_ProxyCount = 0;
+	}
+
+	int32_t DynamicAABBTree::AllocateNode()
+	{
+		if (m_FreeList == NullNode)
+		{
+			m_Nodes.emplace_back();
+			return (int32_t)m_Nodes.size() - 1;
+		}
+
+		int32_t node = m_FreeList;
+		m_FreeList = m_Nodes[node].Parent;
+		m_Nodes[node] = Node();
+		return node;
+	}
+
+	void DynamicAABBTree::FreeNode(int32_t node)
+	{
+		m_Nodes[node].Parent = m_FreeList;
+		m_Nodes[node].Height = -1;
+		m_FreeList = node;
+	}
+
+	void DynamicAABBTree::InsertLeaf(int32_t leaf)
+	{
+		if (m_Root == NullNode)
+		{
+			m_Root = leaf;
+			m_Nodes[leaf].Parent = NullNode;
+			return;
+		}
+
+		// 从根节点向下，选择合并后表面积增加最少的兄弟节点
+		const AABB leafBox = m_Nodes[leaf].Box;
+		int32_t index = m_Root;
+		while (!m_Nodes[index].IsLeaf())
+		{
+			const Node& node = m_Nodes[index];
+
+			float area = node.Box.GetSurfaceArea();
+			float combinedArea = AABB::Union(node.Box, leafBox).GetSurfaceArea();
+
+			// 在这里新建父节点的代价，以及继续下降时祖先节点增大的代价
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto childCost = [&](int32_t child)
+			{
+				const Node& childNode = m_Nodes[child];
+				float childCombinedArea = AABB::Union(leafBox, childNode.Box).GetSurfaceArea();
+				if (childNode.IsLeaf())
+					return childCombinedArea + inheritanceCost;
+				return childCombinedArea - childNode.Box.GetSurfaceArea() + inheritanceCost;
+			};
+
+			float cost1 = childCost(node.Child1);
+			float cost2 = childCost(node.Child2);
+
+			if (cost < cost1 && cost < cost2)
+				break;
+
+			index = cost1 < cost2 ? node.Child1 : node.Child2;
+		}
+
+		int32_t sibling = index;
+
+		// AllocateNode 可能使 m_Nodes 重新分配，之后只通过下标访问
+		int32_t oldParent = m_Nodes[sibling].Parent;
+		int32_t newParent = AllocateNode();
+		m_Nodes[newParent].Parent = oldParent;
+		m_Nodes[newParent].Box = AABB::Union(leafBox, m_Nodes[sibling].Box);
+		m_Nodes[newParent].Height = m_Nodes[sibling].Height + 1;
+		m_Nodes[newParent].Child1 = sibling;
+		m_Nodes[newParent].Child2 = leaf;
+		m_Nodes[sibling].Parent = newParent;
+		m_Nodes[leaf].Parent = newParent;
+
+		if (oldParent != NullNode)
+		{
+			if (m_Nodes[oldParent].Child1 == sibling)
+				m_Nodes[oldParent].Child1 = newParent;
+			else
+				m_Nodes[oldParent].Child2 = newParent;
+		}
+		else
+		{
+			m_Root = newParent;
+		}
+
+		Refit(m_Nodes[leaf].Parent);
+	}
+
+	void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+	{
+		if (leaf == m_Root)
+		{
+			m_Root = NullNode;
+			return;
+		}
+
+		int32_t parent = m_Nodes[leaf].Parent;
+		int32_t grandParent = m_Nodes[parent].Parent;
+		int32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+		// 用兄弟节点替换父节点
+		if (grandParent != NullNode)
+		{
+			if (m_Nodes[grandParent].Child1 == parent)
+				m_Nodes[grandParent].Child1 = sibling;
+			else
+				m_Nodes[grandParent].Child2 = sibling;
+			m_Nodes[sibling].Parent = grandParent;
+			FreeNode(parent);
+
+			Refit(grandParent);
+		}
+		else
+		{
+			m_Root = sibling;
+			m_Nodes[sibling].Parent = NullNode;
+			FreeNode(parent);
+		}
+	}
+
+	void DynamicAABBTree::Refit(int32_t index)
+	{
+		while (index != NullNode)
+		{
+			index = Balance(index);
+
+			Node& node = m_Nodes[index];
+			const Node& child1 = m_Nodes[node.Child1];
+			const Node& child2 = m_Nodes[node.Child2];
+
+			node.Height = 1 + std::max(child1.Height, child2.Height);
+			node.Box = AABB::Union(child1.Box, child2.Box);
+
+			index = node.Parent;
+		}
+	}
+
+	int32_t DynamicAABBTree::Balance(int32_t iA)
+	{
+		Node& A = m_Nodes[iA];
+		if (A.IsLeaf() || A.Height < 2)
+			return iA;
+
+		int32_t iB = A.Child1;
+		int32_t iC = A.Child2;
+		Node& B = m_Nodes[iB];
+		Node& C = m_Nodes[iC];
+
+		int32_t balance = C.Height - B.Height;
+
+		// C 比 B 高，把 C 旋转上来
+		if (balance > 1)
+		{
+			int32_t iF = C.Child1;
+			int32_t iG = C.Child2;
+			Node& F = m_Nodes[iF];
+			Node& G = m_Nodes[iG];
+
+			C.Child1 = iA;
+			C.Parent = A.Parent;
+			A.Parent = iC;
+
+			if (C.Parent != NullNode)
+			{
+				if (m_Nodes[C.Parent].Child1 == iA)
+					m_Nodes[C.Parent].Child1 = iC;
+				else
+					m_Nodes[C.Parent].Child2 = iC;
+			}
+			else
+			{
+				m_Root = iC;
+			}
+
+			if (F.Height > G.Height)
+			{
+				C.Child2 = iF;
+				A.Child2 = iG;
+				G.Parent = iA;
+				A.Box = AABB::Union(B.Box, G.Box);
+				C.Box = AABB::Union(A.Box, F.Box);
+				A.Height = 1 + std::max(B.Height, G.Height);
+				C.Height = 1 + std::max(A.Height, F.Height);
+			}
+			else
+			{
+				C.Child2 = iG;
+				A.Child2 = iF;
+				F.Parent = iA;
+				A.Box = AABB::Union(B.Box, F.Box);
+				C.Box = AABB::Union(A.Box, G.Box);
+				A.Height = 1 + std::max(B.Height, F.Height);
+				C.Height = 1 + std::max(A.Height, G.Height);
+			}
+
+			return iC;
+		}
+
+		// B 比 C 高，把 B 旋转上来
+		if (balance < -1)
+		{
+			int32_t iD = B.Child1;
+			int32_t iE = B.Child2;
+			Node& D = m_Nodes[iD];
+			Node& E = m_Nodes[iE];
+
+			B.Child1 = iA;
+			B.Parent = A.Parent;
+			A.Parent = iB;
+
+			if (B.Parent != NullNode)
+			{
+				if (m_Nodes[B.Parent].Child1 == iA)
+					m_Nodes[B.Parent].Child1 = iB;
+				else
+					m_Nodes[B.Parent].Child2 = iB;
+			}
+			else
+			{
+				m_Root = iB;
+			}
+
+			if (D.Height > E.Height)
+			{
+				B.Child2 = iD;
+				A.Child1 = iE;
+				E.Parent = iA;
+				A.Box = AABB::Union(C.Box, E.Box);
+				B.Box = AABB::Union(A.Box, D.Box);
+				A.Height = 1 + std::max(C.Height, E.Height);
+				B.Height = 1 + std::max(A.Height, D.Height);
+			}
+			else
+			{
+				B.Child2 = iE;
+				A.Child1 = iD;
+				D.Parent = iA;
+				A.Box = AABB::Union(C.Box, D.Box);
+				B.Box = AABB::Union(A.Box, E.Box);
+				A.Height = 1 + std::max(C.Height, D.Height);
+				B.Height = 1 + std::max(A.Height, E.Height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+}
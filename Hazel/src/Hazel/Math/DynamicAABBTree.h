@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Hazel/Math/Frustum.h"
+
+#include <vector>
+
+namespace Hazel {
+
+	/**
+	* 动态 AABB 树（与 Box2D 的 b2DynamicTree 相同的做法）
+	* 叶子节点保存按 margin 放大的包围盒，物体在放大范围内移动时不需要修改树结构，
+	* 插入时按表面积选择兄弟节点，并通过旋转保持平衡，查询只访问与视锥相交的子树。
+	*/
+	class DynamicAABBTree
+	{
+	public:
+		static constexpr int32_t NullNode = -1;
+	public:
+		DynamicAABBTree(float margin = 0.1f);
+
+		/** 插入一个包围盒，返回代理编号，userData 会在查询时返回 */
+		int32_t CreateProxy(const AABB& box, uint32_t userData);
+		void DestroyProxy(int32_t proxy);
+
+		/**
+		* 更新代理的包围盒
+		* @return 包围盒超出了放大范围、需要重新插入时返回 true
+		*/
+		bool MoveProxy(int32_t proxy, const AABB& box);
+
+		uint32_t GetUserData(int32_t proxy) const { return m_Nodes[proxy].UserData; }
+		const AABB& GetFatAABB(int32_t proxy) const { return m_Nodes[proxy].Box; }
+
+		/** 把与视锥相交的代理的 userData 追加到 outUserData，完全在视锥内的子树不再逐个检测 */
+		void Query(const Frustum& frustum, std::vector<uint32_t>& outUserData) const;
+
+		uint32_t GetProxyCount() const { return m_ProxyCount; }
+		int32_t GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].Height; }
+
+		void Clear();
+	private:
+		struct Node
+		{
+			AABB Box;
+			int32_t Parent = NullNode; // 在空闲链表中时为下一个空闲节点
+			int32_t Child1 = NullNode;
+			int32_t Child2 = NullNode;
+			int32_t Height = 0; // 叶子为 0，空闲节点为 -1
+			uint32_t UserData = 0;
+
+			bool IsLeaf() const { return Child1 == NullNode; }
+		};
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t node);
+
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+
+		/** 从 node 向上重新计算包围盒与高度，并在沿途做平衡 */
+		void Refit(int32_t node);
+		/** 子树高度差超过 1 时做一次旋转，返回旋转后该位置的节点 */
+		int32_t Balance(int32_t node);
+	private:
+		std::vector<Node> m_Nodes;
+		int32_t m_Root = NullNode;
+		int32_t m_FreeList = NullNode;
+		uint32_t m_ProxyCount = 0;
+		float m_Margin;
+	};
+
+}
@@ -0,0 +1,51 @@
+#include "hzpch.h"
+#include "Frustum.h"
+
+namespace Hazel {
+
+	Frustum::Frustum(const glm::mat4& viewProjection)
+	{
+		// Gribb-Hartmann：裁剪空间中 -w <= x, y, z <= w，对应矩阵的行组合
+		auto row = [&viewProjection](int i)
+		{
+			return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+		};
+
+		const glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+		m_Planes[0] = r3 + r0; // Left
+		m_Planes[1] = r3 - r0; // Right
+		m_Planes[2] = r3 + r1; // Bottom
+		m_Planes[3] = r3 - r1; // Top
+		m_Planes[4] = r3 + r2; // Near
+		m_Planes[5] = r3 - r2; // Far
+
+		for (glm::vec4& plane : m_Planes)
+		{
+			float length = glm::length(glm::vec3(plane));
+			if (length > 0.0f)
+				plane /= length;
+		}
+	}
+
+	Frustum::Result Frustum::Test(const AABB& box) const
+	{
+		const glm::vec3 center = box.GetCenter();
+		const glm::vec3 extents = box.GetExtents();
+
+		Result result = Result::Inside;
+		for (const glm::vec4& plane : m_Planes)
+		{
+			// 包围盒在平面法线方向上的投影半径
+			const glm::vec3 normal = glm::vec3(plane);
+			float radius = glm::dot(extents, glm::abs(normal));
+			float distance = glm::dot(normal, center) + plane.w;
+
+			if (distance < -radius)
+				return Result::Outside;
+			if (distance < radius)
+				result = Result::Intersect;
+		}
+		return result;
+	}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+
+namespace Hazel {
+
+	/** 世界空间的轴对齐包围盒 */
+	struct AABB
+	{
+		glm::vec3 Min = glm::vec3(0.0f);
+		glm::vec3 Max = glm::vec3(0.0f);
+
+		glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+		/** 表面积，用作 AABB 树插入时的代价 */
+		float GetSurfaceArea() const
+		{
+			glm::vec3 d = Max - Min;
+			return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+		}
+
+		bool Contains(const AABB& other) const
+		{
+			return glm::all(glm::lessThanEqual(Min, other.Min)) && glm::all(glm::greaterThanEqual(Max, other.Max));
+		}
+
+		static AABB Union(const AABB& a, const AABB& b)
+		{
+			return { glm::min(a.Min, b.Min), glm::max(a.Max, b.Max) };
+		}
+
+		static AABB Expand(const AABB& box, float margin)
+		{
+			return { box.Min - glm::vec3(margin), box.Max + glm::vec3(margin) };
+		}
+	};
+
+	/**
+	* 由 ViewProjection 矩阵提取的 6 个裁剪平面（OpenGL 裁剪空间，z ∈ [-1, 1]）
+	* 平面法线指向视锥内部
+	*/
+	class Frustum
+	{
+	public:
+		enum class Result
+		{
+			Outside = 0, Intersect, Inside
+		};
+	public:
+		Frustum() = default;
+		Frustum(const glm::mat4& viewProjection);
+
+		Result Test(const AABB& box) const;
+		bool Intersects(const AABB& box) const { return Test(box) != Result::Outside; }
+	private:
+		std::array<glm::vec4, 6> m_Planes;
+	};
+
+}
@@ -7,7 +7,9 @@ namespace Hazel {
 	/** 定义了在着色器（Shader）中可能使用的数据类型 */
 	enum class ShaderDataType
 	{
-		None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool
+		None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool,
+		/** 压缩格式：半精度浮点、无符号整数、4 个 8 位无符号整数（通常配合 Normalized 作为颜色） */
+		Half, Half2, Half4, UInt, UByte4
 	};
 
 	/** 返回对应数据类型的的字节大小 */
@@ -26,6 +28,11 @@ namespace Hazel {
 		case ShaderDataType::Int3:		return 4 * 3;
 		case ShaderDataType::Int4:		return 4 * 4;
 		case ShaderDataType::Bool:		return 1;
+		case ShaderDataType::Half:		return 2;
+		case ShaderDataType::Half2:		return 2 * 2;
+		case ShaderDataType::Half4:		return 2 * 4;
+		case ShaderDataType::UInt:		return 4;
+		case ShaderDataType::UByte4:	return 4;
 		}
 
 		// 空类型断言
@@ -76,6 +83,11 @@ namespace Hazel {
 			case ShaderDataType::Int3:    return 3;
 			case ShaderDataType::Int4:    return 4;
 			case ShaderDataType::Bool:    return 1;
+			case ShaderDataType::Half:    return 1;
+			case ShaderDataType::Half2:   return 2;
+			case ShaderDataType::Half4:   return 4;
+			case ShaderDataType::UInt:    return 1;
+			case ShaderDataType::UByte4:  return 4;
 			}
 
 			HZ_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -83,6 +95,15 @@ namespace Hazel {
 		}
 	};
 
+	/** 顶点属性的更新频率 */
+	enum class VertexInputRate
+	{
+		/** 每个顶点读取一次 */
+		Vertex = 0,
+		/** 每个实例读取一次（实例化绘制） */
+		Instance
+	};
+
 	/**
 	* 这个类保存了一组 BufferElement，也就是一个顶点数据结构的完整布局：
 	* 图形API（如OpenGL）要求你明确告诉它：你传过去的一堆 float 数组里，每个顶点是怎么排列的。这个 BufferLayout 类就是做这个事情的封装。
@@ -92,15 +113,25 @@ namespace Hazel {
 	public:
 		BufferLayout() {}
 
-		BufferLayout(std::initializer_list<BufferElement> elements)
-			: m_Elements(elements)
+		/**
+		* @param stride 顶点结构体的实际大小，0 表示按元素紧密排列；结构体末尾有对齐填充时需要显式指定
+		*/
+		BufferLayout(std::initializer_list<BufferElement> elements, VertexInputRate inputRate = VertexInputRate::Vertex, uint32_t stride = 0)
+			: m_Elements(elements), m_InputRate(inputRate)
 		{
 			CalculateOffsetsAndStride();
+
+			if (stride)
+			{
+				HZ_CORE_ASSERT(stride >= m_Stride, "Stride is smaller than the size of the elements!");
+				m_Stride = stride;
+			}
 		}
 
 		/** 获取顶点数据步长 */
 		inline uint32_t GetStride() const { return m_Stride; }
 		inline const std::vector<BufferElement>& GetElements() const { return m_Elements; }
+		inline VertexInputRate GetInputRate() const { return m_InputRate; }
 
 		std::vector<BufferElement>::iterator begin() { return m_Elements.begin(); }
 		std::vector<BufferElement>::iterator end() { return m_Elements.end(); }
@@ -124,6 +155,8 @@ namespace Hazel {
 
 		/** 整个顶点占用的字节数（步长） */
 		uint32_t m_Stride = 0;
+
+		VertexInputRate m_InputRate = VertexInputRate::Vertex;
 	};
 
 	/**
@@ -137,7 +170,8 @@ namespace Hazel {
 		virtual void Bind() const = 0;
 		virtual void Unbind() const = 0;
 
-		virtual void SetData(const void* data, uint32_t size) = 0;
+		/** 从字节偏移 offset 开始覆盖写入 size 字节 */
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
 
 		/** 设置顶点数据布局信息 */
 		virtual const BufferLayout& GetLayout() const = 0;
@@ -153,6 +187,75 @@ namespace Hazel {
 		static Ref<VertexBuffer> Create(float* vertices, uint32_t size);
 	};
 
+	/**
+	* 每帧都会重写的动态顶点缓冲，CPU 直接写入常驻映射的显存，没有额外的暂存拷贝
+	* 缓冲按环形使用，总容量为 size * bufferCount，每段被绘制命令使用后由栅栏保护，
+	* GPU 还在读取的区域不会被覆盖；正常情况下 CPU 最多领先 GPU bufferCount 段。
+	*
+	* 用法：Reserve 取得可写指针 -> 写入数据 -> Commit 得到数据偏移 -> 以该偏移发出绘制命令 -> Fence。
+	* 可以连续提交多段数据后用一次间接绘制画出，再调用 Fence 保护它们；
+	* 还没有插入栅栏的数据不会被等待，调用方需要保证新的 Reserve 不会与它们重叠：
+	* 未插入栅栏的区间不超过 bufferCount - 2 段时一定不会重叠。
+	*/
+	class StreamingVertexBuffer : public VertexBuffer
+	{
+	public:
+		virtual ~StreamingVertexBuffer() = default;
+
+		/**
+		* 预留 size 字节供 CPU 写入，必要时等待 GPU 用完这段内存
+		* 返回的地址按布局步长对齐（相对缓冲起点），至少 64 字节对齐的步长同样保证缓存行对齐
+		*/
+		virtual void* Reserve(uint32_t size) = 0;
+
+		/**
+		* 提交最近一次 Reserve 中实际写入的 size 字节
+		* @return 这段数据在缓冲中的字节偏移，是布局步长的整数倍
+		*/
+		virtual uint32_t Commit(uint32_t size) = 0;
+
+		/** 读取之前提交数据的绘制命令都已发出后调用，在这些数据之后插入栅栏 */
+		virtual void Fence() = 0;
+
+		/**
+		* @param size 单次 Reserve 的最大字节数
+		* @param bufferCount 环形缓冲的段数
+		*/
+		static Ref<StreamingVertexBuffer> Create(uint32_t size, uint32_t bufferCount = 3);
+	};
+
+	/** 与 glMultiDrawArraysIndirect 读取的 DrawArraysIndirectCommand 布局一致 */
+	struct DrawArraysIndirectCommand
+	{
+		uint32_t VertexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstVertex;
+		uint32_t BaseInstance;
+	};
+
+	/**
+	* 间接绘制命令缓冲，RenderCommand::MultiDrawInstancedIndirect 用一次调用执行其中的全部命令
+	*/
+	class IndirectBuffer
+	{
+	public:
+		virtual ~IndirectBuffer() = default;
+
+		virtual void Bind() const = 0;
+		virtual void Unbind() const = 0;
+
+		/** 用 count 条命令替换缓冲中的内容，容量不足时自动扩大 */
+		virtual void SetData(const DrawArraysIndirectCommand* commands, uint32_t count) = 0;
+
+		/** 返回命令数量 */
+		virtual uint32_t GetCount() const = 0;
+
+		/**
+		* @param capacity 初始可容纳的命令数量
+		*/
+		static Ref<IndirectBuffer> Create(uint32_t capacity);
+	};
+
 	/**
 	* EBO (索引缓冲对象，Element Buffer Object)
 	* 1.避免重复存储顶点数据，减少内存占用
@@ -0,0 +1,271 @@
+#include "hzpch.h"
+#include "Hazel/Renderer/QuadInstanceKernel.h"
+
+#include "Hazel/Renderer/Renderer2D.h"
+
+#include <glm/gtc/packing.hpp>
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+	#define HZ_TARGET_AVX2
+#else
+	#define HZ_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace Hazel {
+
+	static_assert(sizeof(QuadInstance) == 64, "Quad kernels assume a 64 byte QuadInstance (4 x 16 bytes)");
+
+	namespace Utils {
+
+		static QuadInstanceKernel::ISA DetectISA()
+		{
+		#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 0);
+			const int maxLeaf = info[0];
+
+			__cpuid(info, 1);
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = (info[2] & (1 << 28)) != 0;
+
+			// 除了 CPU 支持外，还需要操作系统在上下文切换时保存 YMM 寄存器
+			bool avxEnabled = false;
+			if (osxsave && avx)
+				avxEnabled = (_xgetbv(0) & 0x6) == 0x6;
+
+			bool avx2 = false;
+			if (maxLeaf >= 7)
+			{
+				__cpuidex(info, 7, 0);
+				avx2 = (info[1] & (1 << 5)) != 0;
+			}
+
+			if (avxEnabled && avx2)
+				return QuadInstanceKernel::ISA::AVX2;
+		#else
+			if (__builtin_cpu_supports("avx2"))
+				return QuadInstanceKernel::ISA::AVX2;
+		#endif
+			// x64 上 SSE2 始终可用
+			return QuadInstanceKernel::ISA::SSE;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		// Scalar ///////////////////////////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////
+
+		/** 一批 Quad 共用、已经压缩好的属性 */
+		struct PackedAttributes
+		{
+			uint32_t Color;
+			uint16_t TexRect[4];
+			uint16_t TilingFactor;
+
+			PackedAttributes(const QuadInstanceAttributes& attributes)
+			{
+				Color = glm::packUnorm4x8(attributes.Color);
+				for (int i = 0; i < 4; i++)
+					TexRect[i] = glm::packHalf1x16(attributes.TexRect[i]);
+				TilingFactor = glm::packHalf1x16(attributes.TilingFactor);
+			}
+		};
+
+		static void WriteQuadsScalar(QuadInstance* dst, const glm::mat4* transforms, uint32_t count, const QuadInstanceAttributes& attributes)
+		{
+			const PackedAttributes packed(attributes);
+
+			for (uint32_t q = 0; q < count; q++)
+			{
+				const glm::mat4& transform = transforms[q];
+
+				dst->AxisX = transform[0];
+				dst->EntityID = attributes.EntityID;
+				dst->AxisY = transform[1];
+				dst->Color = packed.Color;
+				dst->Translation = transform[3];
+				dst->TexIndex = attributes.TexIndex;
+				memcpy(dst->TexRect, packed.TexRect, sizeof(dst->TexRect));
+				dst->TilingFactor = packed.TilingFactor;
+				memset(dst->Padding, 0, sizeof(dst->Padding));
+				dst++;
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		// SSE //////////////////////////////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////
+
+		/**
+		* 一个 QuadInstance 正好是 4 个 128 位寄存器：
+		* [AxisX.xyz, EntityID] [AxisY.xyz, Color] [Translation.xyz, TexIndex] [TexRect, TilingFactor, Padding]
+		* 前三个寄存器取 transform 的第 0、1、3 列，把 w 替换成共用属性的原始比特；最后一个在一批 Quad 中不变。
+		*/
+		struct SSEInstanceConstants
+		{
+			__m128 XYZMask;
+			__m128 AxisXTail;
+			__m128 AxisYTail;
+			__m128 TranslationTail;
+			__m128 Tail;
+
+			SSEInstanceConstants(const QuadInstanceAttributes& attributes)
+			{
+				const PackedAttributes packed(attributes);
+
+				XYZMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+				AxisXTail = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, attributes.EntityID));
+				AxisYTail = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, (int)packed.Color));
+				TranslationTail = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, (int)attributes.TexIndex));
+				Tail = _mm_castsi128_ps(_mm_setr_epi16(
+					(short)packed.TexRect[0], (short)packed.TexRect[1], (short)packed.TexRect[2], (short)packed.TexRect[3],
+					(short)packed.TilingFactor, 0, 0, 0));
+			}
+		};
+
+		template<bool Stream>
+		static inline void Store128(float* dst, __m128 value)
+		{
+			if constexpr (Stream)
+				_mm_stream_ps(dst, value);
+			else
+				_mm_store_ps(dst, value);
+		}
+
+		template<bool Stream>
+		static void WriteQuadsSSE(QuadInstance* dst, const glm::mat4* transforms, uint32_t count, const QuadInstanceAttributes& attributes)
+		{
+			const SSEInstanceConstants constants(attributes);
+
+			float* out = reinterpret_cast<float*>(dst);
+			for (uint32_t q = 0; q < count; q++, out += 16)
+			{
+				const float* m = &transforms[q][0][0];
+
+				Store128<Stream>(out + 0, _mm_or_ps(_mm_and_ps(_mm_loadu_ps(m + 0), constants.XYZMask), constants.AxisXTail));
+				Store128<Stream>(out + 4, _mm_or_ps(_mm_and_ps(_mm_loadu_ps(m + 4), constants.XYZMask), constants.AxisYTail));
+				Store128<Stream>(out + 8, _mm_or_ps(_mm_and_ps(_mm_loadu_ps(m + 12), constants.XYZMask), constants.TranslationTail));
+				Store128<Stream>(out + 12, constants.Tail);
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////
+		// AVX2 /////////////////////////////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////
+
+		template<bool Stream>
+		HZ_TARGET_AVX2 static inline void Store256(float* dst, __m256 value)
+		{
+			if constexpr (Stream)
+				_mm256_stream_ps(dst, value);
+			else
+				_mm256_storeu_ps(dst, value);
+		}
+
+		/**
+		* 每个实例 2 个 256 位写入：[AxisX, AxisY] [Translation, Tail]
+		* transform 的第 0、1 列在内存中相邻，可以一次读入。
+		*/
+		template<bool Stream>
+		HZ_TARGET_AVX2 static void WriteQuadsAVX2(QuadInstance* dst, const glm::mat4* transforms, uint32_t count, const QuadInstanceAttributes& attributes)
+		{
+			const SSEInstanceConstants constants(attributes);
+
+			const __m256 axesMask = _mm256_castsi256_ps(_mm256_setr_epi32(-1, -1, -1, 0, -1, -1, -1, 0));
+			const __m256 axesTail = _mm256_insertf128_ps(_mm256_castps128_ps256(constants.AxisXTail), constants.AxisYTail, 1);
+
+			float* out = reinterpret_cast<float*>(dst);
+			for (uint32_t q = 0; q < count; q++, out += 16)
+			{
+				const float* m = &transforms[q][0][0];
+
+				const __m256 axes = _mm256_or_ps(_mm256_and_ps(_mm256_loadu_ps(m), axesMask), axesTail);
+				const __m128 translation = _mm_or_ps(_mm_and_ps(_mm_loadu_ps(m + 12), constants.XYZMask), constants.TranslationTail);
+
+				Store256<Stream>(out + 0, axes);
+				Store256<Stream>(out + 8, _mm256_insertf128_ps(_mm256_castps128_ps256(translation), constants.Tail, 1));
+			}
+
+			_mm256_zeroupper();
+		}
+
+		using WriteQuadsFn = void(*)(QuadInstance*, const glm::mat4*, uint32_t, const QuadInstanceAttributes&);
+
+		struct KernelTable
+		{
+			WriteQuadsFn Write;
+			WriteQuadsFn Stream;
+		};
+
+		static KernelTable GetKernelTable(QuadInstanceKernel::ISA isa)
+		{
+			switch (isa)
+			{
+			case QuadInstanceKernel::ISA::Scalar: return { WriteQuadsScalar, WriteQuadsScalar };
+			case QuadInstanceKernel::ISA::SSE:    return { WriteQuadsSSE<false>, WriteQuadsSSE<true> };
+			case QuadInstanceKernel::ISA::AVX2:   return { WriteQuadsAVX2<false>, WriteQuadsAVX2<true> };
+			}
+
+			HZ_CORE_ASSERT(false, "Unknown ISA!");
+			return { WriteQuadsScalar, WriteQuadsScalar };
+		}
+
+	}
+
+	static QuadInstanceKernel::ISA s_SupportedISA = Utils::DetectISA();
+	static QuadInstanceKernel::ISA s_ISA = s_SupportedISA;
+	static Utils::KernelTable s_Kernels = Utils::GetKernelTable(s_ISA);
+
+	QuadInstanceKernel::ISA QuadInstanceKernel::GetSupportedISA()
+	{
+		return s_SupportedISA;
+	}
+
+	QuadInstanceKernel::ISA QuadInstanceKernel::GetISA()
+	{
+		return s_ISA;
+	}
+
+	void QuadInstanceKernel::SetISA(ISA isa)
+	{
+		HZ_CORE_ASSERT((int)isa <= (int)s_SupportedISA, "ISA is not supported by this CPU!");
+
+		s_ISA = isa;
+		s_Kernels = Utils::GetKernelTable(isa);
+	}
+
+	const char* QuadInstanceKernel::GetISAName(ISA isa)
+	{
+		switch (isa)
+		{
+		case ISA::Scalar: return "Scalar";
+		case ISA::SSE:    return "SSE";
+		case ISA::AVX2:   return "AVX2";
+		}
+
+		HZ_CORE_ASSERT(false, "Unknown ISA!");
+		return "";
+	}
+
+	void QuadInstanceKernel::WriteQuads(QuadInstance* dst, const glm::mat4* transforms, uint32_t count, const QuadInstanceAttributes& attributes)
+	{
+		HZ_CORE_ASSERT(((uintptr_t)dst & 15) == 0, "Quad instances must be 16 byte aligned!");
+
+		s_Kernels.Write(dst, transforms, count, attributes);
+	}
+
+	void QuadInstanceKernel::StreamQuads(QuadInstance* dst, const glm::mat4* transforms, uint32_t count, const QuadInstanceAttributes& attributes)
+	{
+		HZ_CORE_ASSERT(((uintptr_t)dst & 63) == 0, "Streamed quad instances must be 64 byte aligned!");
+
+		s_Kernels.Stream(dst, transforms, count, attributes);
+	}
+
+	void QuadInstanceKernel::StreamFence()
+	{
+		_mm_sfence();
+	}
+
+}
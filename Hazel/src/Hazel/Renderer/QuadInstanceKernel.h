@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Hazel {
+
+	struct QuadInstance;
+
+	/** 一批 Quad 共用的实例属性 */
+	struct QuadInstanceAttributes
+	{
+		glm::vec4 Color = glm::vec4(1.0f);
+		glm::vec4 TexRect = { 0.0f, 0.0f, 1.0f, 1.0f }; // xy = 左下角纹理坐标，zw = 右上角纹理坐标
+		uint32_t TexIndex = 0; // 纹理槽与标志位，见 QuadInstance::TexIndexMask
+		float TilingFactor = 1.0f;
+		int EntityID = -1;
+	};
+
+	/**
+	* Quad 实例生成内核
+	* 从 transform 中取出 X 轴、Y 轴与平移三列，与压缩后的共用属性一起按 QuadInstance 布局整块写出，
+	* 四个角由顶点着色器展开。
+	* 启动时根据 CPU 支持的指令集选择 AVX2 / SSE / 标量实现。
+	*/
+	class QuadInstanceKernel
+	{
+	public:
+		enum class ISA
+		{
+			Scalar = 0, SSE = 1, AVX2 = 2
+		};
+
+		/** 当前 CPU 支持的最高指令集 */
+		static ISA GetSupportedISA();
+
+		static ISA GetISA();
+		/** 强制使用指定的实现（不能超过 GetSupportedISA），主要用于性能测试对比 */
+		static void SetISA(ISA isa);
+
+		static const char* GetISAName(ISA isa);
+
+		/**
+		* 生成 count 个 Quad 实例，普通写入，适合之后马上会被再次读取的缓存
+		* @param dst 至少能容纳 count 个实例，需要 16 字节对齐
+		*/
+		static void WriteQuads(QuadInstance* dst, const glm::mat4* transforms, uint32_t count, const QuadInstanceAttributes& attributes);
+
+		/**
+		* 同 WriteQuads，但使用 non-temporal 写入绕过 CPU 缓存，适合只会被上传到 GPU 的实例缓存
+		* dst 需要 64 字节对齐，上传前需要调用 StreamFence
+		*/
+		static void StreamQuads(QuadInstance* dst, const glm::mat4* transforms, uint32_t count, const QuadInstanceAttributes& attributes);
+
+		/** 保证之前的 non-temporal 写入对其它线程（驱动）可见 */
+		static void StreamFence();
+	};
+
+}
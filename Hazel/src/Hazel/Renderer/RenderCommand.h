@@ -22,11 +22,31 @@ namespace Hazel {
 			s_RendererAPI->SetViewport(x, y, width, height);
 		}
 
+		inline static void GetViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height)
+		{
+			s_RendererAPI->GetViewport(x, y, width, height);
+		}
+
+		inline static bool SupportsBindlessTextures()
+		{
+			return s_RendererAPI->SupportsBindlessTextures();
+		}
+
 		inline static void SetClearColor(const glm::vec4& color)
 		{
 			s_RendererAPI->SetClearColor(color);
 		}
 
+		inline static void SetBlendEnabled(bool enabled)
+		{
+			s_RendererAPI->SetBlendEnabled(enabled);
+		}
+
+		inline static void SetDepthWriteEnabled(bool enabled)
+		{
+			s_RendererAPI->SetDepthWriteEnabled(enabled);
+		}
+
 		inline static void Clear()
 		{
 			s_RendererAPI->Clear();
@@ -40,14 +60,14 @@ namespace Hazel {
 			s_RendererAPI->DrawIndexed(vertexArray, indexCount);
 		}
 
-		static void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
+		static void DrawInstanced(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t instanceCount, uint32_t baseInstance = 0)
 		{
-			s_RendererAPI->DrawLines(vertexArray, vertexCount);
+			s_RendererAPI->DrawInstanced(vertexArray, vertexCount, instanceCount, baseInstance);
 		}
 
-		static void SetLineWidth(float width)
+		static void MultiDrawInstancedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer)
 		{
-			s_RendererAPI->SetLineWidth(width);
+			s_RendererAPI->MultiDrawInstancedIndirect(vertexArray, indirectBuffer);
 		}
 	private:
 		static Scope<RendererAPI> s_RendererAPI;
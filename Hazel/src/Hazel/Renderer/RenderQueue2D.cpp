@@ -0,0 +1,220 @@
+#include "hzpch.h"
+#include "Hazel/Renderer/RenderQueue2D.h"
+
+namespace Hazel {
+
+	static constexpr uint32_t s_MaxDepth = (1 << 24) - 1;
+
+	void RenderQueue2D::SubmitQuads(const glm::mat4* transforms, uint32_t count, QuadInstanceAttributes attributes, const Ref<Texture>& texture)
+	{
+		const uint32_t textureIndex = texture ? GetTextureIndex(texture) : 0;
+		attributes.TexIndex = (attributes.TexIndex & ~QuadInstance::TexIndexMask) | textureIndex;
+
+		const bool translucent = attributes.Color.a < 1.0f || (texture && texture->HasTransparency());
+
+		size_t first = m_Quads.size();
+		m_Quads.resize(first + count);
+		QuadInstanceKernel::WriteQuads(m_Quads.data() + first, transforms, count, attributes);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t depth = GetDepth(m_Quads[first + i].Translation);
+			m_Commands.push_back({ MakeKey(translucent, Primitive::Quad, textureIndex, depth), (uint32_t)(first + i), Primitive::Quad });
+		}
+	}
+
+	void RenderQueue2D::SubmitQuad(const QuadInstance& instance, const Ref<Texture>& texture)
+	{
+		const uint32_t textureIndex = texture ? GetTextureIndex(texture) : 0;
+		const bool translucent = (instance.Color >> 24) < 0xff || (texture && texture->HasTransparency());
+
+		QuadInstance& quad = m_Quads.emplace_back(instance);
+		quad.TexIndex = (instance.TexIndex & ~QuadInstance::TexIndexMask) | textureIndex;
+
+		uint32_t depth = GetDepth(quad.Translation);
+		m_Commands.push_back({ MakeKey(translucent, Primitive::Quad, textureIndex, depth), (uint32_t)(m_Quads.size() - 1), Primitive::Quad });
+	}
+
+	void RenderQueue2D::SubmitCircle(const CircleInstance& instance)
+	{
+		m_Circles.push_back(instance);
+
+		// 圆的边缘总是带有渐变，按半透明处理
+		uint32_t depth = GetDepth(instance.Translation);
+		m_Commands.push_back({ MakeKey(true, Primitive::Circle, 0, depth), (uint32_t)(m_Circles.size() - 1), Primitive::Circle });
+	}
+
+	void RenderQueue2D::SubmitLine(const LineInstance& instance)
+	{
+		m_Lines.push_back(instance);
+
+		const bool translucent = (instance.Color >> 24) < 0xff;
+		uint32_t depth = GetDepth((instance.P0 + instance.P1) * 0.5f);
+		m_Commands.push_back({ MakeKey(translucent, Primitive::Line, 0, depth), (uint32_t)(m_Lines.size() - 1), Primitive::Line });
+	}
+
+	void RenderQueue2D::Sort()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		const size_t count = m_Commands.size();
+		if (count < 2)
+			return;
+
+		// LSD 基数排序，每次 8 位，先一次性统计 8 个字节的直方图
+		constexpr int passes = 8;
+		std::array<std::array<uint32_t, 256>, passes> histograms = {};
+		for (const Command& command : m_Commands)
+		{
+			for (int pass = 0; pass < passes; pass++)
+				histograms[pass][(command.Key >> (pass * 8)) & 0xff]++;
+		}
+
+		m_SortBuffer.resize(count);
+		Command* src = m_Commands.data();
+		Command* dst = m_SortBuffer.data();
+		for (int pass = 0; pass < passes; pass++)
+		{
+			auto& histogram = histograms[pass];
+
+			// 所有键在这个字节上都相同，跳过这一轮
+			if (histogram[(src[0].Key >> (pass * 8)) & 0xff] == count)
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t& bucket : histogram)
+			{
+				uint32_t bucketCount = bucket;
+				bucket = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				dst[histogram[(src[i].Key >> (pass * 8)) & 0xff]++] = src[i];
+
+			std::swap(src, dst);
+		}
+
+		if (src != m_Commands.data())
+			m_Commands.swap(m_SortBuffer);
+	}
+
+	uint32_t RenderQueue2D::CountBatchBreaks(const BatchLimits& limits) const
+	{
+		HZ_PROFILE_FUNCTION();
+
+		// 模拟 Renderer2D 的合批过程：每种图元独立成批，Quad 还会因为纹理槽用完开启新批次
+		std::vector<uint32_t> textureBatch(m_Textures.size(), 0);
+		uint32_t quadBatch = 1;
+		uint32_t quadCount = 0, circleCount = 0, lineCount = 0, textureCount = 0;
+		uint32_t breaks = 0;
+
+		auto nextQuadBatch = [&]()
+		{
+			quadBatch++;
+			breaks++;
+			quadCount = textureCount = 0;
+		};
+
+		for (const Command& command : m_Commands)
+		{
+			switch (command.Type)
+			{
+				case Primitive::Quad:
+				{
+					if (quadCount >= limits.MaxQuads)
+						nextQuadBatch();
+
+					uint32_t texture = m_Quads[command.Index].TexIndex & QuadInstance::TexIndexMask;
+					if (texture && textureBatch[texture] != quadBatch)
+					{
+						if (textureCount >= limits.MaxTextures)
+							nextQuadBatch();
+
+						textureBatch[texture] = quadBatch;
+						textureCount++;
+					}
+					quadCount++;
+					break;
+				}
+				case Primitive::Circle:
+				{
+					if (circleCount >= limits.MaxCircles)
+					{
+						breaks++;
+						circleCount = 0;
+					}
+					circleCount++;
+					break;
+				}
+				case Primitive::Line:
+				{
+					if (lineCount >= limits.MaxLines)
+					{
+						breaks++;
+						lineCount = 0;
+					}
+					lineCount++;
+					break;
+				}
+			}
+		}
+
+		return breaks;
+	}
+
+	void RenderQueue2D::Reset()
+	{
+		m_Commands.clear();
+		m_Quads.clear();
+		m_Circles.clear();
+		m_Lines.clear();
+
+		m_Textures.resize(1);
+		m_TextureIndices.clear();
+	}
+
+	uint32_t RenderQueue2D::GetTextureIndex(const Ref<Texture>& texture)
+	{
+		auto it = m_TextureIndices.find(texture.get());
+		if (it != m_TextureIndices.end())
+			return it->second;
+
+		HZ_CORE_ASSERT(m_Textures.size() <= QuadInstance::TexIndexMask, "Too many textures in one render queue!");
+
+		uint32_t index = (uint32_t)m_Textures.size();
+		m_Textures.push_back(texture);
+		m_TextureIndices[texture.get()] = index;
+		return index;
+	}
+
+	uint32_t RenderQueue2D::GetDepth(const glm::vec3& position) const
+	{
+		glm::vec4 clip = m_ViewProjection * glm::vec4(position, 1.0f);
+		float ndcZ = clip.w != 0.0f ? clip.z / clip.w : clip.z;
+
+		// [-1, 1] -> [0, MaxDepth]，视锥外的图元夹到两端
+		float depth = glm::clamp(ndcZ * 0.5f + 0.5f, 0.0f, 1.0f);
+		return (uint32_t)(depth * (float)s_MaxDepth);
+	}
+
+	uint64_t RenderQueue2D::MakeKey(bool translucent, Primitive type, uint32_t texture, uint32_t depth) const
+	{
+		uint64_t key = (uint64_t)m_Layer << 56;
+		if (translucent)
+		{
+			// 半透明图元的先后影响混合结果，深度相同时按提交顺序（即将加入的命令下标）而不是纹理排列
+			key |= 1ull << 55;
+			key |= (uint64_t)(s_MaxDepth - depth) << 31;
+			key |= (uint64_t)(m_Commands.size() & 0x7fffffff);
+		}
+		else
+		{
+			key |= (uint64_t)type << 53;
+			key |= (uint64_t)depth << 29;
+			key |= (uint64_t)(texture & 0xffff) << 13;
+		}
+		return key;
+	}
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Hazel/Renderer/Renderer2D.h"
+
+namespace Hazel {
+
+	/**
+	* Renderer2D 的延迟提交队列
+	* 绘制调用先被记录成紧凑的命令（64 位排序键 + 图元数据下标），EndScene 时用基数排序按键排列后再统一合批。
+	*
+	* 排序键从高位到低位：
+	* 不透明：[Layer 8][0][Shader 2][Depth 24，由近到远][Texture 16][13]
+	* 半透明：[Layer 8][1][Depth 24，由远到近][Sequence 31，提交顺序]
+	* 不透明图元由近到远绘制并写入深度，被遮挡的片元在 early-Z 阶段剔除，深度相同时按状态分组；
+	* 半透明图元保证由远到近的混合顺序，深度相同（2D 场景中通常都在 z = 0）时保持提交顺序，混合结果与不排序时一致。
+	* 注意：深度完全相同且互相重叠的不透明图元在 GL_LESS 下先绘制的可见，排序后先后由纹理决定，
+	* 与不排序时可能不同；需要确定的遮挡关系时应给它们不同的 z。
+	* 颜色 alpha 小于 1 或纹理含有半透明像素（Texture::HasTransparency）的 Quad 按半透明处理。
+	* 基数排序是稳定的，键完全相同的命令保持提交顺序。
+	*/
+	class RenderQueue2D
+	{
+	public:
+		enum class Primitive : uint8_t
+		{
+			Quad = 0, Circle = 1, Line = 2
+		};
+
+		struct Command
+		{
+			uint64_t Key;
+			uint32_t Index; // 在对应图元数组中的下标
+			Primitive Type;
+		};
+
+		/** 合批时各类图元的容量，用于统计批次中断 */
+		struct BatchLimits
+		{
+			uint32_t MaxQuads;
+			uint32_t MaxCircles;
+			uint32_t MaxLines;
+			uint32_t MaxTextures; // 不含 0 号白色纹理
+		};
+	public:
+		/** 用于计算深度，每个场景开始时设置 */
+		void SetViewProjection(const glm::mat4& viewProjection) { m_ViewProjection = viewProjection; }
+
+		/** 之后提交的图元所在的层，层号小的先绘制 */
+		void SetLayer(uint8_t layer) { m_Layer = layer; }
+		uint8_t GetLayer() const { return m_Layer; }
+
+		/** 记录 count 个共用属性的 Quad，texture 为空时使用白色纹理 */
+		void SubmitQuads(const glm::mat4* transforms, uint32_t count, QuadInstanceAttributes attributes, const Ref<Texture>& texture);
+		/** 记录一个已经生成好的 Quad 实例，instance.TexIndex 中的纹理索引会被替换成 texture 在队列中的索引 */
+		void SubmitQuad(const QuadInstance& instance, const Ref<Texture>& texture);
+		void SubmitCircle(const CircleInstance& instance);
+		void SubmitLine(const LineInstance& instance);
+
+		/** 排序键是否属于半透明通道 */
+		static bool IsTranslucent(uint64_t key) { return (key >> 55) & 1; }
+		/** 排序键中的层号 */
+		static uint8_t GetKeyLayer(uint64_t key) { return (uint8_t)(key >> 56); }
+
+		/** 按排序键对命令做稳定的基数排序 */
+		void Sort();
+
+		/** 按命令当前的顺序合批时，因为容量或纹理槽不足而中断批次的次数（Sort 之前为提交顺序） */
+		uint32_t CountBatchBreaks(const BatchLimits& limits) const;
+
+		/** 清空命令，保留已分配的内存 */
+		void Reset();
+
+		bool IsEmpty() const { return m_Commands.empty(); }
+		const std::vector<Command>& GetCommands() const { return m_Commands; }
+		const std::vector<QuadInstance>& GetQuads() const { return m_Quads; }
+		const std::vector<CircleInstance>& GetCircles() const { return m_Circles; }
+		const std::vector<LineInstance>& GetLines() const { return m_Lines; }
+
+		/** 队列内纹理索引对应的纹理，0 为白色纹理，返回空 */
+		const Ref<Texture>& GetTexture(uint32_t index) const { return m_Textures[index]; }
+	private:
+		uint32_t GetTextureIndex(const Ref<Texture>& texture);
+
+		/** 把世界坐标换算成 24 位的深度值，越小越靠近相机 */
+		uint32_t GetDepth(const glm::vec3& position) const;
+
+		/** 需要在命令加入 m_Commands 之前调用，半透明命令以当前命令数作为提交顺序 */
+		uint64_t MakeKey(bool translucent, Primitive type, uint32_t texture, uint32_t depth) const;
+	private:
+		glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+		uint8_t m_Layer = 0;
+
+		std::vector<Command> m_Commands;
+		std::vector<Command> m_SortBuffer;
+
+		std::vector<QuadInstance> m_Quads;
+		std::vector<CircleInstance> m_Circles;
+		std::vector<LineInstance> m_Lines;
+
+		/** m_Textures[0] 为空，表示白色纹理 */
+		std::vector<Ref<Texture>> m_Textures = { nullptr };
+		std::unordered_map<Texture*, uint32_t> m_TextureIndices;
+	};
+
+}
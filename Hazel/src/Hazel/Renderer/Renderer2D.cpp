@@ -5,90 +5,123 @@
 #include "Hazel/Renderer/Shader.h"
 #include "Hazel/Renderer/RenderCommand.h"
 #include "Hazel/Renderer/UniformBuffer.h"
+#include "Hazel/Renderer/StorageBuffer.h"
+#include "Hazel/Renderer/QuadInstanceKernel.h"
+#include "Hazel/Renderer/RenderQueue2D.h"
+#include "Hazel/Renderer/TextureAtlas.h"
+#include "Hazel/Renderer/TextureArrayPool.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/packing.hpp>
 
 // https://chatgpt.com/c/67fa38bd-a720-8007-8da7-d33db289e844
 namespace Hazel {
 
-	struct QuadVertex
-	{
-		glm::vec3 Position;
-		glm::vec4 Color;
-		glm::vec2 TexCoord;
-		float TexIndex;
-		float TilingFactor;
-
-		// Editor-only
-		int EntityID;
-	};
-
-	struct CircleVertex
-	{
-		glm::vec3 WorldPosition;
-		glm::vec3 LocalPosition;
-		glm::vec4 Color;
-		float Thickness;
-		float Fade;
-
-		// Editor-only
-		int EntityID;
-	};
-
-	struct LineVertex
-	{
-		glm::vec3 Position;
-		glm::vec4 Color;
-
-		// Editor-only
-		int EntityID;
-	};
-
 	struct Renderer2DData
 	{
-		static const uint32_t MaxQuads = 20000;
-		static const uint32_t MaxVertices = MaxQuads * 4;
-		static const uint32_t MaxIndices = MaxQuads * 6;
-		static const uint32_t MaxTextureSlots = 32; // TODO: RenderCaps
+		/** 32 个纹理单元中 0 ~ 23 为 sampler2D，24 ~ 31 为 sampler2DArray */
+		static const uint32_t MaxTextureSlots = 24; // TODO: RenderCaps
+		static const uint32_t MaxTextureArraySlots = 8;
+		/** 无绑定纹理模式下一个批次最多引用的纹理数量，即句柄表的大小 */
+		static const uint32_t MaxBindlessTextures = 4096;
+
+		/** 实例缓冲的环形段数 */
+		static const uint32_t StreamingSegments = 4;
+		/**
+		* 一次间接绘制最多合并的批次数。新的批次 Reserve 时，还没有插入栅栏的批次不超过 StreamingSegments - 2 段，
+		* 环形缓冲回绕时才能保证不覆盖它们，所以攒够 StreamingSegments - 1 个批次就必须先绘制。
+		* 批次容量在 BeginScene 时按上一个场景的图元数量增长（GrowBuffers），容量上限以内一帧的每种图元
+		* 在每个通道中只有一个批次，也就只有一次间接绘制；这个上限只在超出 Max*Capacity 的场景中起作用，
+		* 此时再增加段数会按段数成倍占用显存，因此保留固定的段数。
+		*/
+		static const uint32_t MaxPendingBatches = StreamingSegments - 1;
+		// Reserve 只断言、不等待未插入栅栏的区间，攒批的上限放宽到这个界限之外会在发布版本中覆盖还没有绘制的实例
+		static_assert(StreamingSegments >= 2 && MaxPendingBatches - 1 <= StreamingSegments - 2, "Pending batches can overlap in the streaming instance buffers!");
+
+		Renderer2DSpecification Specification;
+
+		/** 当前每种图元单个批次的容量，场景中的数量超出后按 GrowthFactor 增长 */
+		uint32_t MaxQuads = 0;
+		uint32_t MaxCircles = 0;
+		uint32_t MaxLines = 0;
+
+		/** 当前场景中各图元的总数，在下一次 BeginScene 时决定是否需要增长 */
+		uint32_t SceneQuadCount = 0;
+		uint32_t SceneCircleCount = 0;
+		uint32_t SceneLineCount = 0;
 
 		Ref<VertexArray> QuadVertexArray;
-		Ref<VertexBuffer> QuadVertexBuffer;
+		Ref<StreamingVertexBuffer> QuadInstanceBuffer;
 		Ref<Shader> QuadShader;
+		Ref<Shader> QuadBindlessShader;
 		Ref<Texture2D> WhiteTexture;
 
 		Ref<VertexArray> CircleVertexArray;
-		Ref<VertexBuffer> CircleVertexBuffer;
+		Ref<StreamingVertexBuffer> CircleInstanceBuffer;
 		Ref<Shader> CircleShader;
 
 		Ref<VertexArray> LineVertexArray;
-		Ref<VertexBuffer> LineVertexBuffer;
+		Ref<StreamingVertexBuffer> LineInstanceBuffer;
 		Ref<Shader> LineShader;
 
-		uint32_t QuadIndexCount = 0;
-		QuadVertex* QuadVertexBufferBase = nullptr;
-		QuadVertex* QuadVertexBufferPtr = nullptr;
+		uint32_t QuadInstanceCount = 0;
+		QuadInstance* QuadInstanceBufferBase = nullptr;
+		QuadInstance* QuadInstanceBufferPtr = nullptr;
 
-		uint32_t CircleIndexCount = 0;
-		CircleVertex* CircleVertexBufferBase = nullptr;
-		CircleVertex* CircleVertexBufferPtr = nullptr;
+		uint32_t CircleInstanceCount = 0;
+		CircleInstance* CircleInstanceBufferBase = nullptr;
+		CircleInstance* CircleInstanceBufferPtr = nullptr;
 
-		uint32_t LineVertexCount = 0;
-		LineVertex* LineVertexBufferBase = nullptr;
-		LineVertex* LineVertexBufferPtr = nullptr;
+		uint32_t LineInstanceCount = 0;
+		LineInstance* LineInstanceBufferBase = nullptr;
+		LineInstance* LineInstanceBufferPtr = nullptr;
+
+		/** 已提交、还没有绘制的批次，每种图元用一次 MultiDraw 调用画出 */
+		std::vector<DrawArraysIndirectCommand> QuadCommands;
+		std::vector<DrawArraysIndirectCommand> CircleCommands;
+		std::vector<DrawArraysIndirectCommand> LineCommands;
+		Ref<IndirectBuffer> CommandBuffer;
 
 		float LineWidth = 2.0f;
 
-		std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
+		/** 无绑定纹理模式下纹理槽只是句柄表的下标，容量为 MaxBindlessTextures，否则为 MaxTextureSlots */
+		bool Bindless = false;
+		uint32_t TextureSlotCapacity = MaxTextureSlots;
+		std::vector<Ref<Texture>> TextureSlots;
 		uint32_t TextureSlotIndex = 1; // 0 = white texture
 
+		/** TextureArraySlots[i] 绑定在纹理单元 MaxTextureSlots + i */
+		std::array<Ref<Texture>, MaxTextureArraySlots> TextureArraySlots;
+		uint32_t TextureArraySlotIndex = 0;
+
+		std::vector<uint64_t> TextureHandles;
+		Ref<StorageBuffer> TextureHandleBuffer;
+
+		/** 每次清空纹理槽时递增，作为纹理槽缓存的有效标记；容量不足开启的新批次沿用原来的纹理槽 */
+		uint32_t BatchGeneration = 0;
+
 		glm::vec4 QuadVertexPositions[4];
 
+		TextureAtlas SpriteAtlas;
+		bool SpriteAtlasEnabled = true;
+
+		TextureArrayPool SpriteArrays;
+		bool SpriteArraysEnabled = true;
+
+		RenderQueue2D Queue;
+		bool SortingEnabled = true;
+		bool Sorting = false; // 当前场景的绘制是否进入排序队列，在 BeginScene 时确定
+
+		/** 开启排序时，当前场景中提交、还没有绘制的保留缓存 */
+		std::vector<Renderer2D::RetainedBatch*> RetainedBatches;
+
 		Renderer2D::Statistics Stats;
 
 		struct CameraData
 		{
 			glm::mat4 ViewProjection;
+			glm::vec2 ViewportSize; // 像素，线段着色器用它把线宽换算到裁剪空间
 		};
 		CameraData CameraBuffer;
 		Ref<UniformBuffer> CameraUniformBuffer;
@@ -96,72 +129,178 @@ namespace Hazel {
 
 	static Renderer2DData s_Data;
 
-	void Renderer2D::Init()
+	/** 当前视口的像素大小，Framebuffer::Bind 也会修改视口，因此每个场景开始时重新读取 */
+	static glm::vec2 GetViewportSize()
 	{
-		HZ_PROFILE_FUNCTION();
+		uint32_t x, y, width, height;
+		RenderCommand::GetViewport(x, y, width, height);
+		return { (float)width, (float)height };
+	}
 
-		s_Data.QuadVertexArray = VertexArray::Create();
+	static void BeginQueue()
+	{
+		s_Data.Sorting = s_Data.SortingEnabled;
+		s_Data.Queue.SetViewProjection(s_Data.CameraBuffer.ViewProjection);
+		s_Data.Queue.SetLayer(0);
+	}
+
+	/** 执行 commands 中的全部批次，只有一个批次时直接绘制，省去上传间接命令 */
+	static void ExecuteCommands(const Ref<VertexArray>& vertexArray, std::vector<DrawArraysIndirectCommand>& commands)
+	{
+		if (commands.size() == 1)
+		{
+			const DrawArraysIndirectCommand& command = commands.front();
+			RenderCommand::DrawInstanced(vertexArray, command.VertexCount, command.InstanceCount, command.BaseInstance);
+		}
+		else
+		{
+			s_Data.CommandBuffer->SetData(commands.data(), (uint32_t)commands.size());
+			RenderCommand::MultiDrawInstancedIndirect(vertexArray, s_Data.CommandBuffer);
+		}
 
-		s_Data.QuadVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(QuadVertex));
-		s_Data.QuadVertexBuffer->SetLayout({
-			{ ShaderDataType::Float3,	"a_Position" },
-			{ ShaderDataType::Float4,	"a_Color" },
-			{ ShaderDataType::Float2,	"a_TexCoord" },
-			{ ShaderDataType::Float,	"a_TexIndex" },
-			{ ShaderDataType::Float,	"a_TilingFactor" },
-			{ ShaderDataType::Int,		"a_EntityID" }
-		});
-		s_Data.QuadVertexArray->AddVertexBuffer(s_Data.QuadVertexBuffer);
+		s_Data.Stats.DrawCalls++;
+		s_Data.Stats.Batches += (uint32_t)commands.size();
+		commands.clear();
+	}
 
-		s_Data.QuadVertexBufferBase = new QuadVertex[s_Data.MaxVertices];
+	/**
+	* 不透明通道关闭混合并写入深度，半透明通道开启混合、只做深度测试
+	* 两个通道都保留深度测试，半透明图元不会画在更近的不透明图元之上
+	*/
+	static void SetTranslucentState(bool translucent)
+	{
+		RenderCommand::SetBlendEnabled(translucent);
+		RenderCommand::SetDepthWriteEnabled(!translucent);
+	}
 
-		uint32_t* quadIndices = new uint32_t[s_Data.MaxIndices];
+	static void WriteCircle(CircleInstance* dst, const glm::mat4& transform, const glm::vec4& color, float thickness, float fade, int entityID)
+	{
+		dst->AxisX = transform[0];
+		dst->EntityID = entityID;
+		dst->AxisY = transform[1];
+		dst->Color = glm::packUnorm4x8(color);
+		dst->Translation = transform[3];
+		dst->Thickness = glm::packHalf1x16(thickness);
+		dst->Fade = glm::packHalf1x16(fade);
+	}
 
-		uint32_t offset = 0;
-		for (uint32_t i = 0; i < s_Data.MaxIndices; i += 6)
-		{
-			quadIndices[i + 0] = offset + 0;
-			quadIndices[i + 1] = offset + 1;
-			quadIndices[i + 2] = offset + 2;
+	/** QuadInstance 的实例属性布局，批次缓冲与保留缓存共用 */
+	static BufferLayout GetQuadInstanceLayout()
+	{
+		return BufferLayout({
+			{ ShaderDataType::Float3,	"a_AxisX" },
+			{ ShaderDataType::Int,		"a_EntityID" },
+			{ ShaderDataType::Float3,	"a_AxisY" },
+			{ ShaderDataType::UByte4,	"a_Color", true },
+			{ ShaderDataType::Float3,	"a_Translation" },
+			{ ShaderDataType::UInt,		"a_TexIndex" },
+			{ ShaderDataType::Half4,	"a_TexRect" },
+			{ ShaderDataType::Half,		"a_TilingFactor" }
+		}, VertexInputRate::Instance, sizeof(QuadInstance));
+	}
 
-			quadIndices[i + 3] = offset + 2;
-			quadIndices[i + 4] = offset + 3;
-			quadIndices[i + 5] = offset + 0;
+	/** 按容量重新创建实例缓冲与顶点数组，只能在没有未提交数据时调用 */
+	static void CreateQuadBuffer(uint32_t capacity)
+	{
+		s_Data.MaxQuads = capacity;
 
-			offset += 4;
-		}
+		// Quad 与 Circle 都是实例化绘制：每个图元一条实例数据，顶点着色器用 gl_VertexIndex 展开成两个三角形，不需要索引缓冲
+		s_Data.QuadVertexArray = VertexArray::Create();
 
-		Ref<IndexBuffer> quadIB = IndexBuffer::Create(quadIndices, s_Data.MaxIndices);
-		s_Data.QuadVertexArray->SetIndexBuffer(quadIB);
-		delete[] quadIndices;
+		// 实例数据直接写入常驻映射的环形缓冲，每个批次开始时预留空间
+		s_Data.QuadInstanceBuffer = StreamingVertexBuffer::Create(capacity * sizeof(QuadInstance), Renderer2DData::StreamingSegments);
+		s_Data.QuadInstanceBuffer->SetLayout(GetQuadInstanceLayout());
+		s_Data.QuadVertexArray->AddVertexBuffer(s_Data.QuadInstanceBuffer);
+	}
+
+	static void CreateCircleBuffer(uint32_t capacity)
+	{
+		s_Data.MaxCircles = capacity;
 
-		// Circles
 		s_Data.CircleVertexArray = VertexArray::Create();
 
-		s_Data.CircleVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(CircleVertex));
-		s_Data.CircleVertexBuffer->SetLayout({
-			{ ShaderDataType::Float3, "a_WorldPosition" },
-			{ ShaderDataType::Float3, "a_LocalPosition" },
-			{ ShaderDataType::Float4, "a_Color"         },
-			{ ShaderDataType::Float,  "a_Thickness"     },
-			{ ShaderDataType::Float,  "a_Fade"          },
-			{ ShaderDataType::Int,    "a_EntityID"      }
-		});
-		s_Data.CircleVertexArray->AddVertexBuffer(s_Data.CircleVertexBuffer);
-		s_Data.CircleVertexArray->SetIndexBuffer(quadIB); // Use quad IB
-		s_Data.CircleVertexBufferBase = new CircleVertex[s_Data.MaxVertices];
+		s_Data.CircleInstanceBuffer = StreamingVertexBuffer::Create(capacity * sizeof(CircleInstance), Renderer2DData::StreamingSegments);
+		s_Data.CircleInstanceBuffer->SetLayout(BufferLayout({
+			{ ShaderDataType::Float3, "a_AxisX"             },
+			{ ShaderDataType::Int,    "a_EntityID"          },
+			{ ShaderDataType::Float3, "a_AxisY"             },
+			{ ShaderDataType::UByte4, "a_Color",       true },
+			{ ShaderDataType::Float3, "a_Translation"       },
+			{ ShaderDataType::Half,   "a_Thickness"         },
+			{ ShaderDataType::Half,   "a_Fade"              }
+		}, VertexInputRate::Instance));
+		s_Data.CircleVertexArray->AddVertexBuffer(s_Data.CircleInstanceBuffer);
+	}
 
-		// Lines
+	static void CreateLineBuffer(uint32_t capacity)
+	{
+		s_Data.MaxLines = capacity;
+
+		// 线段同样是实例化绘制，每条线段展开成一个屏幕空间的矩形，不再依赖 glLineWidth
 		s_Data.LineVertexArray = VertexArray::Create();
 
-		s_Data.LineVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(LineVertex));
-		s_Data.LineVertexBuffer->SetLayout({
-			{ ShaderDataType::Float3, "a_Position" },
-			{ ShaderDataType::Float4, "a_Color"    },
-			{ ShaderDataType::Int,    "a_EntityID" }
-		});
-		s_Data.LineVertexArray->AddVertexBuffer(s_Data.LineVertexBuffer);
-		s_Data.LineVertexBufferBase = new LineVertex[s_Data.MaxVertices];
+		s_Data.LineInstanceBuffer = StreamingVertexBuffer::Create(capacity * sizeof(LineInstance), Renderer2DData::StreamingSegments);
+		s_Data.LineInstanceBuffer->SetLayout(BufferLayout({
+			{ ShaderDataType::Float3, "a_P0"             },
+			{ ShaderDataType::Int,    "a_EntityID"       },
+			{ ShaderDataType::Float3, "a_P1"             },
+			{ ShaderDataType::UByte4, "a_Color",    true },
+			{ ShaderDataType::Float,  "a_Width"          }
+		}, VertexInputRate::Instance));
+		s_Data.LineVertexArray->AddVertexBuffer(s_Data.LineInstanceBuffer);
+	}
+
+	/** 上一个场景中的数量超过批次容量时，按增长系数扩大到能容纳为止（不超过上限） */
+	static uint32_t GrowCapacity(uint32_t capacity, uint32_t required, uint32_t maxCapacity)
+	{
+		const float growthFactor = s_Data.Specification.GrowthFactor;
+		if (growthFactor <= 1.0f)
+			return capacity;
+
+		while (capacity < required && capacity < maxCapacity)
+			capacity = std::min(maxCapacity, std::max(capacity + 1, (uint32_t)(capacity * growthFactor)));
+		return capacity;
+	}
+
+	static void GrowBuffers()
+	{
+		const Renderer2DSpecification& spec = s_Data.Specification;
+
+		uint32_t maxQuads = GrowCapacity(s_Data.MaxQuads, s_Data.SceneQuadCount, spec.MaxQuadCapacity);
+		if (maxQuads != s_Data.MaxQuads)
+		{
+			HZ_CORE_INFO("Renderer2D: quad batch capacity {0} -> {1}", s_Data.MaxQuads, maxQuads);
+			CreateQuadBuffer(maxQuads);
+		}
+
+		uint32_t maxCircles = GrowCapacity(s_Data.MaxCircles, s_Data.SceneCircleCount, spec.MaxCircleCapacity);
+		if (maxCircles != s_Data.MaxCircles)
+		{
+			HZ_CORE_INFO("Renderer2D: circle batch capacity {0} -> {1}", s_Data.MaxCircles, maxCircles);
+			CreateCircleBuffer(maxCircles);
+		}
+
+		uint32_t maxLines = GrowCapacity(s_Data.MaxLines, s_Data.SceneLineCount, spec.MaxLineCapacity);
+		if (maxLines != s_Data.MaxLines)
+		{
+			HZ_CORE_INFO("Renderer2D: line batch capacity {0} -> {1}", s_Data.MaxLines, maxLines);
+			CreateLineBuffer(maxLines);
+		}
+
+		s_Data.SceneQuadCount = 0;
+		s_Data.SceneCircleCount = 0;
+		s_Data.SceneLineCount = 0;
+	}
+
+	void Renderer2D::Init(const Renderer2DSpecification& specification)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		s_Data.Specification = specification;
+
+		CreateQuadBuffer(specification.QuadCapacity);
+		CreateCircleBuffer(specification.CircleCapacity);
+		CreateLineBuffer(specification.LineCapacity);
 
 		s_Data.WhiteTexture = Texture2D::Create(1, 1);
 		uint32_t whiteTextureData = 0xffffffff;
@@ -175,7 +314,24 @@ namespace Hazel {
 		s_Data.CircleShader = Shader::Create("assets/shaders/Renderer2D_Circle.glsl");
 		s_Data.LineShader = Shader::Create("assets/shaders/Renderer2D_Line.glsl");
 
+		s_Data.Bindless = specification.BindlessTextures && RenderCommand::SupportsBindlessTextures();
+		if (s_Data.Bindless)
+		{
+			s_Data.TextureSlotCapacity = Renderer2DData::MaxBindlessTextures;
+			s_Data.QuadBindlessShader = Shader::Create("assets/shaders/Renderer2D_QuadBindless.glsl");
+
+			s_Data.TextureHandles.resize(Renderer2DData::MaxBindlessTextures);
+			s_Data.TextureHandleBuffer = StorageBuffer::Create(Renderer2DData::MaxBindlessTextures * sizeof(uint64_t), 1);
+			s_Data.TextureHandles[0] = s_Data.WhiteTexture->GetBindlessHandle();
+		}
+		else
+		{
+			s_Data.TextureSlotCapacity = Renderer2DData::MaxTextureSlots;
+		}
+		HZ_CORE_INFO("Renderer2D: {0}", s_Data.Bindless ? "bindless textures" : "texture slot binding");
+
 		// Set first texture slot to 0
+		s_Data.TextureSlots.resize(s_Data.TextureSlotCapacity);
 		s_Data.TextureSlots[0] = s_Data.WhiteTexture;
 
 		// 当前以中心点为锚点
@@ -185,15 +341,32 @@ namespace Hazel {
 		s_Data.QuadVertexPositions[3] = { -0.5f,  0.5f, 0.0f, 1.0f };
 
 		s_Data.CameraUniformBuffer = UniformBuffer::Create(sizeof(Renderer2DData::CameraData), 0);
+
+		s_Data.CommandBuffer = IndirectBuffer::Create(Renderer2DData::MaxPendingBatches);
 	}
 
 	void Renderer2D::Shutdown()
 	{
 		HZ_PROFILE_FUNCTION();
 
-		delete[] s_Data.QuadVertexBufferBase;
-		s_Data.QuadVertexBufferBase = nullptr;
-		s_Data.QuadVertexBufferPtr = nullptr;
+		// 映射内存随缓冲一起释放
+		s_Data.QuadInstanceBufferBase = nullptr;
+		s_Data.QuadInstanceBufferPtr = nullptr;
+		s_Data.CircleInstanceBufferBase = nullptr;
+		s_Data.CircleInstanceBufferPtr = nullptr;
+		s_Data.LineInstanceBufferBase = nullptr;
+		s_Data.LineInstanceBufferPtr = nullptr;
+
+		s_Data.QuadInstanceBuffer = nullptr;
+		s_Data.CircleInstanceBuffer = nullptr;
+		s_Data.LineInstanceBuffer = nullptr;
+		s_Data.CommandBuffer = nullptr;
+		s_Data.TextureHandleBuffer = nullptr;
+		s_Data.TextureSlots.clear();
+		s_Data.TextureHandles.clear();
+
+		s_Data.SpriteAtlas.Clear();
+		s_Data.SpriteArrays.Clear();
 	}
 
 	void Renderer2D::BeginScene(const Camera& camera, const glm::mat4& transform)
@@ -201,8 +374,11 @@ namespace Hazel {
 		HZ_PROFILE_FUNCTION();
 
 		s_Data.CameraBuffer.ViewProjection = camera.GetProjection() * glm::inverse(transform);
+		s_Data.CameraBuffer.ViewportSize = GetViewportSize();
 		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
 
+		BeginQueue();
+		GrowBuffers();
 		StartBatch();
 	}
 
@@ -211,8 +387,11 @@ namespace Hazel {
 		HZ_PROFILE_FUNCTION();
 
 		s_Data.CameraBuffer.ViewProjection = camera.GetViewProjection();
+		s_Data.CameraBuffer.ViewportSize = GetViewportSize();
 		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
 
+		BeginQueue();
+		GrowBuffers();
 		StartBatch();
 	}
 
@@ -221,8 +400,11 @@ namespace Hazel {
 		HZ_PROFILE_FUNCTION();
 
 		s_Data.CameraBuffer.ViewProjection = camera.GetViewProjectionMatrix();
+		s_Data.CameraBuffer.ViewportSize = GetViewportSize();
 		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
 
+		BeginQueue();
+		GrowBuffers();
 		StartBatch();
 	}
 
@@ -230,45 +412,109 @@ namespace Hazel {
 	{
 		HZ_PROFILE_FUNCTION();
 
+		if (s_Data.Sorting)
+		{
+			FlushQueue();
+			s_Data.Sorting = false;
+		}
+
 		Flush();
+
+		// 排序队列中没有排在保留缓存之后的命令时在最后绘制
+		DrawPendingRetained();
 	}
 
 	void Renderer2D::Flush()
 	{
-		if (s_Data.QuadIndexCount)
-		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.QuadVertexBufferPtr - (uint8_t*)s_Data.QuadVertexBufferBase);
-			s_Data.QuadVertexBuffer->SetData(s_Data.QuadVertexBufferBase, dataSize);
+		FlushQuads();
+		FlushCircles();
+		FlushLines();
 
-			// Bind textures
+		ExecuteQuads();
+		ExecuteCircles();
+		ExecuteLines();
+	}
+
+	void Renderer2D::FlushQuads()
+	{
+		if (s_Data.QuadInstanceCount == 0)
+			return;
+
+		QuadInstanceKernel::StreamFence();
+
+		uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.QuadInstanceBufferPtr - (uint8_t*)s_Data.QuadInstanceBufferBase);
+		uint32_t baseInstance = s_Data.QuadInstanceBuffer->Commit(dataSize) / sizeof(QuadInstance);
+		s_Data.QuadCommands.push_back({ 6, s_Data.QuadInstanceCount, 0, baseInstance });
+
+		s_Data.SceneQuadCount += s_Data.QuadInstanceCount;
+	}
+
+	void Renderer2D::FlushCircles()
+	{
+		if (s_Data.CircleInstanceCount == 0)
+			return;
+
+		uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.CircleInstanceBufferPtr - (uint8_t*)s_Data.CircleInstanceBufferBase);
+		uint32_t baseInstance = s_Data.CircleInstanceBuffer->Commit(dataSize) / sizeof(CircleInstance);
+		s_Data.CircleCommands.push_back({ 6, s_Data.CircleInstanceCount, 0, baseInstance });
+
+		s_Data.SceneCircleCount += s_Data.CircleInstanceCount;
+	}
+
+	void Renderer2D::FlushLines()
+	{
+		if (s_Data.LineInstanceCount == 0)
+			return;
+
+		uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.LineInstanceBufferPtr - (uint8_t*)s_Data.LineInstanceBufferBase);
+		uint32_t baseInstance = s_Data.LineInstanceBuffer->Commit(dataSize) / sizeof(LineInstance);
+		s_Data.LineCommands.push_back({ 6, s_Data.LineInstanceCount, 0, baseInstance });
+
+		s_Data.SceneLineCount += s_Data.LineInstanceCount;
+	}
+
+	void Renderer2D::ExecuteQuads()
+	{
+		if (s_Data.QuadCommands.empty())
+			return;
+
+		// 等待中的批次共用同一组纹理槽
+		if (s_Data.Bindless)
+		{
+			s_Data.TextureHandleBuffer->SetData(s_Data.TextureHandles.data(), s_Data.TextureSlotIndex * sizeof(uint64_t));
+			s_Data.QuadBindlessShader->Bind();
+		}
+		else
+		{
 			for (uint32_t i = 0; i < s_Data.TextureSlotIndex; i++)
 				s_Data.TextureSlots[i]->Bind(i);
+			for (uint32_t i = 0; i < s_Data.TextureArraySlotIndex; i++)
+				s_Data.TextureArraySlots[i]->Bind(Renderer2DData::MaxTextureSlots + i);
 
 			s_Data.QuadShader->Bind();
-			RenderCommand::DrawIndexed(s_Data.QuadVertexArray, s_Data.QuadIndexCount);
-			s_Data.Stats.DrawCalls++;
 		}
+		ExecuteCommands(s_Data.QuadVertexArray, s_Data.QuadCommands);
+		s_Data.QuadInstanceBuffer->Fence();
+	}
 
-		if (s_Data.CircleIndexCount)
-		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.CircleVertexBufferPtr - (uint8_t*)s_Data.CircleVertexBufferBase);
-			s_Data.CircleVertexBuffer->SetData(s_Data.CircleVertexBufferBase, dataSize);
+	void Renderer2D::ExecuteCircles()
+	{
+		if (s_Data.CircleCommands.empty())
+			return;
 
-			s_Data.CircleShader->Bind();
-			RenderCommand::DrawIndexed(s_Data.CircleVertexArray, s_Data.CircleIndexCount);
-			s_Data.Stats.DrawCalls++;
-		}
+		s_Data.CircleShader->Bind();
+		ExecuteCommands(s_Data.CircleVertexArray, s_Data.CircleCommands);
+		s_Data.CircleInstanceBuffer->Fence();
+	}
 
-		if (s_Data.LineVertexCount)
-		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.LineVertexBufferPtr - (uint8_t*)s_Data.LineVertexBufferBase);
-			s_Data.LineVertexBuffer->SetData(s_Data.LineVertexBufferBase, dataSize);
+	void Renderer2D::ExecuteLines()
+	{
+		if (s_Data.LineCommands.empty())
+			return;
 
-			s_Data.LineShader->Bind();
-			RenderCommand::SetLineWidth(s_Data.LineWidth);
-			RenderCommand::DrawLines(s_Data.LineVertexArray, s_Data.LineVertexCount);
-			s_Data.Stats.DrawCalls++;
-		}
+		s_Data.LineShader->Bind();
+		ExecuteCommands(s_Data.LineVertexArray, s_Data.LineCommands);
+		s_Data.LineInstanceBuffer->Fence();
 	}
 
 	void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
@@ -305,78 +551,69 @@ namespace Hazel {
 	{
 		HZ_PROFILE_FUNCTION();
 
-		constexpr size_t quadVertexCount = 4;
-		const float textureIndex = 0.0f; // White Texture
-		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
-		const float tilingFactor = 1.0f;
-
-		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
-			NextBatch();
+		QuadInstanceAttributes attributes;
+		attributes.Color = color;
+		attributes.EntityID = entityID;
+		SubmitQuads(&transform, 1, attributes);
+	}
 
-		for (size_t i = 0; i < quadVertexCount; i++)
-		{
-			s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[i];
-			s_Data.QuadVertexBufferPtr->Color = color;
-			s_Data.QuadVertexBufferPtr->TexCoord = textureCoords[i];
-			s_Data.QuadVertexBufferPtr->TexIndex = textureIndex;
-			s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-			s_Data.QuadVertexBufferPtr->EntityID = entityID;
-			s_Data.QuadVertexBufferPtr++;
-		}
+	void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor, int entityID)
+	{
+		HZ_PROFILE_FUNCTION();
 
-		s_Data.QuadIndexCount += 6;
+		QuadInstanceAttributes attributes;
+		attributes.Color = tintColor;
+		attributes.TilingFactor = tilingFactor;
+		attributes.EntityID = entityID;
+		SubmitQuads(&transform, 1, attributes, texture);
+	}
 
-		s_Data.Stats.QuadCount++;
+	void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const Ref<SubTexture2D>& subTexture, float tilingFactor, const glm::vec4& tintColor)
+	{
+		DrawQuad({ position.x, position.y, 0.0f }, size, subTexture, tilingFactor, tintColor);
 	}
 
-	void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor, int entityID)
+	void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const Ref<SubTexture2D>& subTexture, float tilingFactor, const glm::vec4& tintColor)
 	{
 		HZ_PROFILE_FUNCTION();
 
-		constexpr size_t quadVertexCount = 4;
-		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
+			* glm::scale(glm::mat4(1.0f), { size.x, size.y, 1.0f });
 
-		// 达到当前批次绘制的最大值，重置状态，重新绘制
-		if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
-			NextBatch();
+		DrawQuad(transform, subTexture, tilingFactor, tintColor);
+	}
 
-		// 在已有的 TextureSlots 数组中查询是否已经存储过 texture 数据
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < s_Data.TextureSlotIndex; i++)
-		{
-			if (*s_Data.TextureSlots[i] == *texture)
-			{
-				textureIndex = (float)i;
-				break;
-			}
-		}
+	void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<SubTexture2D>& subTexture, float tilingFactor, const glm::vec4& tintColor, int entityID)
+	{
+		HZ_PROFILE_FUNCTION();
 
-		// 如果没有则新增数据
-		if (textureIndex == 0.0f)
-		{
-			// 纹理插槽以达到当前最大值
-			if (s_Data.TextureSlotIndex >= Renderer2DData::MaxTextureSlots)
-				NextBatch();
+		QuadInstanceAttributes attributes;
+		attributes.Color = tintColor;
+		attributes.TexRect = subTexture->GetTexRect();
+		attributes.TilingFactor = tilingFactor;
+		attributes.EntityID = entityID;
+		SubmitQuads(&transform, 1, attributes, subTexture->GetTexture());
+	}
 
-			textureIndex = (float)s_Data.TextureSlotIndex;
-			s_Data.TextureSlots[s_Data.TextureSlotIndex] = texture;
-			s_Data.TextureSlotIndex++;
-		}
+	void Renderer2D::DrawQuads(const glm::mat4* transforms, uint32_t count, const glm::vec4& color, int entityID)
+	{
+		HZ_PROFILE_FUNCTION();
 
-		for (size_t i = 0; i < quadVertexCount; i++)
-		{
-			s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[i];
-			s_Data.QuadVertexBufferPtr->Color = tintColor;
-			s_Data.QuadVertexBufferPtr->TexCoord = textureCoords[i];
-			s_Data.QuadVertexBufferPtr->TexIndex = textureIndex;
-			s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-			s_Data.QuadVertexBufferPtr->EntityID = entityID;
-			s_Data.QuadVertexBufferPtr++;
-		}
+		QuadInstanceAttributes attributes;
+		attributes.Color = color;
+		attributes.EntityID = entityID;
+		SubmitQuads(transforms, count, attributes);
+	}
 
-		s_Data.QuadIndexCount += 6;
+	void Renderer2D::DrawQuads(const glm::mat4* transforms, uint32_t count, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor, int entityID)
+	{
+		HZ_PROFILE_FUNCTION();
 
-		s_Data.Stats.QuadCount++;
+		QuadInstanceAttributes attributes;
+		attributes.Color = tintColor;
+		attributes.TilingFactor = tilingFactor;
+		attributes.EntityID = entityID;
+		SubmitQuads(transforms, count, attributes, texture);
 	}
 
 	void Renderer2D::DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color)
@@ -415,39 +652,40 @@ namespace Hazel {
 	{
 		HZ_PROFILE_FUNCTION();
 
-		// TODO: implement for circles
-		// if (s_Data.QuadIndexCount >= Renderer2DData::MaxIndices)
-		// 	NextBatch();
-
-		for (size_t i = 0; i < 4; i++)
+		if (s_Data.Sorting)
 		{
-			s_Data.CircleVertexBufferPtr->WorldPosition = transform * s_Data.QuadVertexPositions[i];
-			s_Data.CircleVertexBufferPtr->LocalPosition = s_Data.QuadVertexPositions[i] * 2.0f;
-			s_Data.CircleVertexBufferPtr->Color = color;
-			s_Data.CircleVertexBufferPtr->Thickness = thickness;
-			s_Data.CircleVertexBufferPtr->Fade = fade;
-			s_Data.CircleVertexBufferPtr->EntityID = entityID;
-			s_Data.CircleVertexBufferPtr++;
+			CircleInstance instance;
+			WriteCircle(&instance, transform, color, thickness, fade, entityID);
+			s_Data.Queue.SubmitCircle(instance);
+			return;
 		}
 
-		s_Data.CircleIndexCount += 6;
+		if (s_Data.CircleInstanceCount >= s_Data.MaxCircles)
+			NextCircleBatch();
+
+		WriteCircle(s_Data.CircleInstanceBufferPtr, transform, color, thickness, fade, entityID);
+		s_Data.CircleInstanceBufferPtr++;
+		s_Data.CircleInstanceCount++;
 
 		s_Data.Stats.QuadCount++;
 	}
 
 	void Renderer2D::DrawLine(const glm::vec3& p0, glm::vec3& p1, const glm::vec4& color, int entityID)
 	{
-		s_Data.LineVertexBufferPtr->Position = p0;
-		s_Data.LineVertexBufferPtr->Color = color;
-		s_Data.LineVertexBufferPtr->EntityID = entityID;
-		s_Data.LineVertexBufferPtr++;
+		LineInstance instance = { p0, entityID, p1, glm::packUnorm4x8(color), s_Data.LineWidth };
+
+		if (s_Data.Sorting)
+		{
+			s_Data.Queue.SubmitLine(instance);
+			return;
+		}
 
-		s_Data.LineVertexBufferPtr->Position = p1;
-		s_Data.LineVertexBufferPtr->Color = color;
-		s_Data.LineVertexBufferPtr->EntityID = entityID;
-		s_Data.LineVertexBufferPtr++;
+		if (s_Data.LineInstanceCount >= s_Data.MaxLines)
+			NextLineBatch();
 
-		s_Data.LineVertexCount += 2;
+		*s_Data.LineInstanceBufferPtr = instance;
+		s_Data.LineInstanceBufferPtr++;
+		s_Data.LineInstanceCount++;
 	}
 
 	void Renderer2D::DrawRect(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, int entityID)
@@ -475,12 +713,511 @@ namespace Hazel {
 		DrawLine(lineVertices[3], lineVertices[0], color);
 	}
 
+	/** 精灵实际绘制用的纹理与属性，可以打包的小纹理换成图集页及其中的纹理坐标，没有纹理时返回空 */
+	static Ref<Texture2D> ResolveSprite(SpriteRendererComponent& src, QuadInstanceAttributes& attributes)
+	{
+		attributes.Color = src.Color;
+		if (!src.Texture)
+			return nullptr;
+
+		// 平铺的纹理需要整张纹理的坐标空间，不能从图集中绘制
+		if (s_Data.SpriteAtlasEnabled && src.TilingFactor == 1.0f && !src.Texture->GetPath().empty())
+		{
+			if (Ref<SubTexture2D> subTexture = s_Data.SpriteAtlas.Add(src.Texture))
+			{
+				attributes.TexRect = subTexture->GetTexRect();
+				return subTexture->GetTexture();
+			}
+		}
+
+		attributes.TilingFactor = src.TilingFactor;
+		return src.Texture;
+	}
+
+	/** 纹理数组只用于纹理槽绑定模式，无绑定纹理没有纹理槽限制 */
+	static bool UseTextureArrays()
+	{
+		return s_Data.SpriteArraysEnabled && !s_Data.Bindless;
+	}
+
+	static void SetTextureArrayLayer(QuadInstanceAttributes& attributes, uint32_t layer)
+	{
+		attributes.TexIndex = QuadInstance::TexArrayFlag | (layer << QuadInstance::TexLayerShift);
+	}
+
 	void Renderer2D::DrawSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		QuadInstanceAttributes attributes;
+		attributes.EntityID = entityID;
+		Ref<Texture2D> texture = ResolveSprite(src, attributes);
+
+		// 没有进入图集的文件纹理再尝试放入纹理数组
+		TextureArrayLayer layer;
+		if (texture == src.Texture && texture && UseTextureArrays() && !texture->GetPath().empty() && s_Data.SpriteArrays.Add(texture, layer))
+		{
+			SetTextureArrayLayer(attributes, layer.Layer);
+			SubmitQuads(&transform, 1, attributes, layer.Array);
+			return;
+		}
+
+		SubmitQuads(&transform, 1, attributes, texture);
+	}
+
+	void Renderer2D::ThreadBatch::DrawQuad(const glm::mat4& transform, const glm::vec4& color, int entityID)
+	{
+		QuadInstanceAttributes attributes;
+		attributes.Color = color;
+		attributes.TexIndex = 0; // White Texture
+		attributes.EntityID = entityID;
+
+		// 线程批次之后马上会被 Submit 读取，使用普通写入保留在缓存中
+		QuadInstanceKernel::WriteQuads(&m_QuadInstances.emplace_back(), &transform, 1, attributes);
+	}
+
+	void Renderer2D::ThreadBatch::DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor, int entityID)
+	{
+		QuadInstanceAttributes attributes;
+		attributes.Color = tintColor;
+		attributes.TexIndex = GetLocalTextureIndex(texture);
+		attributes.TilingFactor = tilingFactor;
+		attributes.EntityID = entityID;
+
+		QuadInstanceKernel::WriteQuads(&m_QuadInstances.emplace_back(), &transform, 1, attributes);
+	}
+
+	void Renderer2D::ThreadBatch::DrawQuad(const glm::mat4& transform, const Ref<SubTexture2D>& subTexture, float tilingFactor, const glm::vec4& tintColor, int entityID)
+	{
+		QuadInstanceAttributes attributes;
+		attributes.Color = tintColor;
+		attributes.TexRect = subTexture->GetTexRect();
+		attributes.TexIndex = GetLocalTextureIndex(subTexture->GetTexture());
+		attributes.TilingFactor = tilingFactor;
+		attributes.EntityID = entityID;
+
+		QuadInstanceKernel::WriteQuads(&m_QuadInstances.emplace_back(), &transform, 1, attributes);
+	}
+
+	void Renderer2D::ThreadBatch::DrawCircle(const glm::mat4& transform, const glm::vec4& color, float thickness, float fade, int entityID)
+	{
+		WriteCircle(&m_CircleInstances.emplace_back(), transform, color, thickness, fade, entityID);
+	}
+
+	void Renderer2D::ThreadBatch::DrawLine(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color, int entityID)
+	{
+		// 线宽在渲染线程上设置，工作线程只读取
+		m_LineInstances.push_back({ p0, entityID, p1, glm::packUnorm4x8(color), s_Data.LineWidth });
+	}
+
+	void Renderer2D::ThreadBatch::DrawSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID)
 	{
 		if (src.Texture)
+		{
+			// 工作线程只查找已经打包的纹理，还没有打包的纹理在 Submit 时由渲染线程打包，下一帧开始生效
+			if (s_Data.SpriteAtlasEnabled && src.TilingFactor == 1.0f)
+			{
+				if (Ref<SubTexture2D> subTexture = s_Data.SpriteAtlas.Find(src.Texture))
+				{
+					DrawQuad(transform, subTexture, 1.0f, src.Color, entityID);
+					return;
+				}
+			}
+
+			TextureArrayLayer layer;
+			if (UseTextureArrays() && s_Data.SpriteArrays.Find(src.Texture, layer))
+			{
+				QuadInstanceAttributes attributes;
+				attributes.Color = src.Color;
+				SetTextureArrayLayer(attributes, layer.Layer);
+				attributes.TexIndex |= GetLocalTextureIndex(layer.Array);
+				attributes.TilingFactor = src.TilingFactor;
+				attributes.EntityID = entityID;
+
+				QuadInstanceKernel::WriteQuads(&m_QuadInstances.emplace_back(), &transform, 1, attributes);
+				return;
+			}
+
 			DrawQuad(transform, src.Texture, src.TilingFactor, src.Color, entityID);
+		}
 		else
+		{
 			DrawQuad(transform, src.Color, entityID);
+		}
+	}
+
+	void Renderer2D::ThreadBatch::Reset()
+	{
+		m_QuadInstances.clear();
+		m_CircleInstances.clear();
+		m_LineInstances.clear();
+		m_Textures.clear();
+	}
+
+	uint32_t Renderer2D::ThreadBatch::GetLocalTextureIndex(const Ref<Texture>& texture)
+	{
+		// 局部纹理表没有 32 个槽位的限制，超出部分在 Submit 时按批次拆分
+		for (size_t i = 0; i < m_Textures.size(); i++)
+		{
+			if (m_Textures[i] == texture)
+				return (uint32_t)(i + 1);
+		}
+
+		HZ_CORE_ASSERT(m_Textures.size() < QuadInstance::TexIndexMask, "Too many textures in one thread batch!");
+
+		m_Textures.push_back(texture);
+		return (uint32_t)m_Textures.size();
+	}
+
+	void Renderer2D::Submit(ThreadBatch& batch)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		// 工作线程中没有命中图集的纹理在这里打包，下一帧开始从图集或纹理数组绘制
+		if (s_Data.SpriteAtlasEnabled || UseTextureArrays())
+		{
+			for (const Ref<Texture>& texture : batch.m_Textures)
+			{
+				// 只有从文件加载的 Texture2D 有路径，图集页与纹理数组都没有
+				if (texture->GetPath().empty())
+					continue;
+
+				Ref<Texture2D> texture2D = std::static_pointer_cast<Texture2D>(texture);
+				if (s_Data.SpriteAtlasEnabled && s_Data.SpriteAtlas.Add(texture2D))
+					continue;
+
+				TextureArrayLayer layer;
+				if (UseTextureArrays())
+					s_Data.SpriteArrays.Add(texture2D, layer);
+			}
+		}
+
+		if (s_Data.Sorting)
+		{
+			for (const QuadInstance& instance : batch.m_QuadInstances)
+			{
+				uint32_t localIndex = instance.TexIndex & QuadInstance::TexIndexMask;
+				s_Data.Queue.SubmitQuad(instance, localIndex ? batch.m_Textures[localIndex - 1] : nullptr);
+			}
+
+			for (const CircleInstance& instance : batch.m_CircleInstances)
+				s_Data.Queue.SubmitCircle(instance);
+
+			for (const LineInstance& instance : batch.m_LineInstances)
+				s_Data.Queue.SubmitLine(instance);
+			return;
+		}
+
+		// Quads
+		if (!batch.m_QuadInstances.empty())
+		{
+			// 局部纹理索引 -> 当前批次的纹理槽，负数表示在当前批次中还未分配
+			std::vector<int32_t> slotMap(batch.m_Textures.size() + 1, -1);
+			uint32_t slotMapGeneration = s_Data.BatchGeneration;
+
+			const QuadInstance* src = batch.m_QuadInstances.data();
+			const size_t quadCount = batch.m_QuadInstances.size();
+			for (size_t q = 0; q < quadCount; q++, src++)
+			{
+				if (s_Data.QuadInstanceCount >= s_Data.MaxQuads)
+					NextQuadBatch();
+
+				// 纹理槽被清空后之前的映射全部失效
+				if (slotMapGeneration != s_Data.BatchGeneration)
+				{
+					std::fill(slotMap.begin(), slotMap.end(), -1);
+					slotMapGeneration = s_Data.BatchGeneration;
+				}
+
+				uint32_t localIndex = src->TexIndex & QuadInstance::TexIndexMask;
+				int32_t textureIndex = slotMap[localIndex];
+				if (textureIndex < 0)
+				{
+					if (localIndex == 0)
+					{
+						textureIndex = 0; // White Texture
+					}
+					else
+					{
+						textureIndex = (int32_t)GetTextureSlot(batch.m_Textures[localIndex - 1], src->TexIndex & QuadInstance::TexArrayFlag);
+
+						// GetTextureSlot 可能因为纹理槽已满而清空纹理槽
+						if (slotMapGeneration != s_Data.BatchGeneration)
+						{
+							std::fill(slotMap.begin(), slotMap.end(), -1);
+							slotMapGeneration = s_Data.BatchGeneration;
+						}
+					}
+					slotMap[localIndex] = textureIndex;
+				}
+
+				*s_Data.QuadInstanceBufferPtr = *src;
+				s_Data.QuadInstanceBufferPtr->TexIndex = (src->TexIndex & ~QuadInstance::TexIndexMask) | (uint32_t)textureIndex;
+				s_Data.QuadInstanceBufferPtr++;
+
+				s_Data.QuadInstanceCount++;
+			}
+
+			s_Data.Stats.QuadCount += (uint32_t)quadCount;
+		}
+
+		// Circles
+		{
+			const CircleInstance* src = batch.m_CircleInstances.data();
+			size_t remaining = batch.m_CircleInstances.size();
+			while (remaining)
+			{
+				if (s_Data.CircleInstanceCount >= s_Data.MaxCircles)
+					NextCircleBatch();
+
+				size_t count = std::min<size_t>(remaining, s_Data.MaxCircles - s_Data.CircleInstanceCount);
+				memcpy(s_Data.CircleInstanceBufferPtr, src, count * sizeof(CircleInstance));
+				s_Data.CircleInstanceBufferPtr += count;
+				s_Data.CircleInstanceCount += (uint32_t)count;
+				s_Data.Stats.QuadCount += (uint32_t)count;
+
+				src += count;
+				remaining -= count;
+			}
+		}
+
+		// Lines
+		{
+			const LineInstance* src = batch.m_LineInstances.data();
+			size_t remaining = batch.m_LineInstances.size();
+			while (remaining)
+			{
+				if (s_Data.LineInstanceCount >= s_Data.MaxLines)
+					NextLineBatch();
+
+				size_t count = std::min<size_t>(remaining, s_Data.MaxLines - s_Data.LineInstanceCount);
+				memcpy(s_Data.LineInstanceBufferPtr, src, count * sizeof(LineInstance));
+				s_Data.LineInstanceBufferPtr += count;
+				s_Data.LineInstanceCount += (uint32_t)count;
+
+				src += count;
+				remaining -= count;
+			}
+		}
+	}
+
+	uint32_t Renderer2D::RetainedBatch::Allocate()
+	{
+		if (!m_FreeSlots.empty())
+		{
+			uint32_t slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+			return slot;
+		}
+
+		uint32_t slot = (uint32_t)m_Instances.size();
+		m_Instances.emplace_back();
+		m_Occupied.push_back(false);
+		m_Dirty.push_back(false);
+		ClearSlot(slot);
+		return slot;
+	}
+
+	void Renderer2D::RetainedBatch::Free(uint32_t slot)
+	{
+		HZ_CORE_ASSERT(slot < m_Instances.size(), "Invalid retained slot!");
+
+		ClearSlot(slot);
+		m_FreeSlots.push_back(slot);
+	}
+
+	bool Renderer2D::RetainedBatch::SetSprite(uint32_t& slot, const glm::mat4& transform, SpriteRendererComponent& src, int entityID)
+	{
+		QuadInstanceAttributes attributes;
+		attributes.EntityID = entityID;
+		Ref<Texture2D> texture = ResolveSprite(src, attributes);
+
+		// 半透明精灵需要与其它图元一起由远到近排序，逐帧经过排序队列绘制
+		const bool translucent = attributes.Color.a < 1.0f || (texture && texture->HasTransparency());
+
+		// 先引用新纹理再释放旧纹理，纹理不变时不会先腾出再占用表项
+		attributes.TexIndex = texture && !translucent ? AcquireTexture(texture) : 0;
+		if (translucent || (texture && attributes.TexIndex == 0))
+		{
+			if (slot != InvalidSlot)
+				Free(slot);
+			slot = InvalidSlot;
+			return false;
+		}
+
+		if (slot == InvalidSlot)
+			slot = Allocate();
+		HZ_CORE_ASSERT(slot < m_Instances.size(), "Invalid retained slot!");
+
+		if (m_Occupied[slot])
+			ReleaseTexture(m_Instances[slot].TexIndex & QuadInstance::TexIndexMask);
+		else
+			m_Count++;
+		m_Occupied[slot] = true;
+
+		QuadInstanceKernel::WriteQuads(&m_Instances[slot], &transform, 1, attributes);
+		MarkDirty(slot);
+		return true;
+	}
+
+	void Renderer2D::RetainedBatch::ClearSlot(uint32_t slot)
+	{
+		if (m_Occupied[slot])
+		{
+			ReleaseTexture(m_Instances[slot].TexIndex & QuadInstance::TexIndexMask);
+			m_Occupied[slot] = false;
+			m_Count--;
+		}
+
+		// 两个轴都为零时四个角重合，三角形面积为零，不会产生任何片元
+		QuadInstance& instance = m_Instances[slot];
+		memset(&instance, 0, sizeof(QuadInstance));
+		instance.EntityID = -1;
+		MarkDirty(slot);
+	}
+
+	void Renderer2D::RetainedBatch::MarkDirty(uint32_t slot)
+	{
+		if (m_Dirty[slot])
+			return;
+
+		m_Dirty[slot] = true;
+		m_DirtySlots.push_back(slot);
+	}
+
+	uint32_t Renderer2D::RetainedBatch::AcquireTexture(const Ref<Texture2D>& texture)
+	{
+		uint32_t freeIndex = MaxTextures;
+		for (uint32_t i = 0; i < MaxTextures; i++)
+		{
+			if (m_Textures[i] == texture)
+			{
+				m_TextureRefCounts[i]++;
+				return i + 1;
+			}
+
+			if (!m_Textures[i] && freeIndex == MaxTextures)
+				freeIndex = i;
+		}
+
+		if (freeIndex == MaxTextures)
+			return 0;
+
+		m_Textures[freeIndex] = texture;
+		m_TextureRefCounts[freeIndex] = 1;
+		return freeIndex + 1;
+	}
+
+	void Renderer2D::RetainedBatch::ReleaseTexture(uint32_t index)
+	{
+		if (index == 0) // White Texture
+			return;
+
+		HZ_CORE_ASSERT(m_TextureRefCounts[index - 1] > 0, "Retained texture released too many times!");
+		if (--m_TextureRefCounts[index - 1] == 0)
+			m_Textures[index - 1] = nullptr;
+	}
+
+	void Renderer2D::RetainedBatch::Upload()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		const uint32_t slotCount = (uint32_t)m_Instances.size();
+
+		// 槽位数量超过 GPU 缓冲容量时按两倍扩容，新缓冲需要整体上传
+		if (slotCount > m_Capacity)
+		{
+			m_Capacity = std::max<uint32_t>(1024, m_Capacity);
+			while (m_Capacity < slotCount)
+				m_Capacity *= 2;
+
+			m_VertexArray = VertexArray::Create();
+			m_InstanceBuffer = VertexBuffer::Create(m_Capacity * sizeof(QuadInstance));
+			m_InstanceBuffer->SetLayout(GetQuadInstanceLayout());
+			m_VertexArray->AddVertexBuffer(m_InstanceBuffer);
+
+			m_InstanceBuffer->SetData(m_Instances.data(), slotCount * sizeof(QuadInstance));
+
+			for (uint32_t slot : m_DirtySlots)
+				m_Dirty[slot] = false;
+			m_DirtySlots.clear();
+			return;
+		}
+
+		if (m_DirtySlots.empty())
+			return;
+
+		// 排序后把相邻的脏槽位合并成区间，间隔很小的区间一起上传，减少 glBufferSubData 的调用次数
+		static constexpr uint32_t MaxGap = 16;
+
+		std::sort(m_DirtySlots.begin(), m_DirtySlots.end());
+
+		uint32_t begin = m_DirtySlots[0], end = begin + 1;
+		for (size_t i = 1; i <= m_DirtySlots.size(); i++)
+		{
+			if (i < m_DirtySlots.size() && m_DirtySlots[i] <= end + MaxGap)
+			{
+				end = m_DirtySlots[i] + 1;
+				continue;
+			}
+
+			m_InstanceBuffer->SetData(&m_Instances[begin], (end - begin) * sizeof(QuadInstance), begin * sizeof(QuadInstance));
+
+			if (i < m_DirtySlots.size())
+			{
+				begin = m_DirtySlots[i];
+				end = begin + 1;
+			}
+		}
+
+		for (uint32_t slot : m_DirtySlots)
+			m_Dirty[slot] = false;
+		m_DirtySlots.clear();
+	}
+
+	void Renderer2D::DrawRetained(RetainedBatch& batch)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		batch.Upload();
+
+		if (batch.m_Count == 0)
+			return;
+
+		// 排序时等第 0 层的不透明命令画完再绘制，见 FlushQueue
+		s_Data.RetainedBatches.push_back(&batch);
+		if (!s_Data.Sorting)
+			DrawPendingRetained();
+	}
+
+	void Renderer2D::DrawPendingRetained()
+	{
+		if (s_Data.RetainedBatches.empty())
+			return;
+
+		// 保留缓存使用自己的纹理槽，等待中的批次的纹理在执行时会重新绑定
+		SetTranslucentState(false);
+		s_Data.QuadShader->Bind();
+		for (RetainedBatch* batch : s_Data.RetainedBatches)
+		{
+			s_Data.WhiteTexture->Bind(0);
+			for (uint32_t i = 0; i < RetainedBatch::MaxTextures; i++)
+			{
+				if (batch->m_Textures[i])
+					batch->m_Textures[i]->Bind(i + 1);
+			}
+
+			RenderCommand::DrawInstanced(batch->m_VertexArray, 6, (uint32_t)batch->m_Instances.size(), 0);
+
+			s_Data.Stats.DrawCalls++;
+			s_Data.Stats.QuadCount += batch->m_Count;
+			s_Data.Stats.OpaqueQuadCount += batch->m_Count;
+		}
+		s_Data.RetainedBatches.clear();
+
+		// 恢复默认的混合与深度写入
+		RenderCommand::SetBlendEnabled(true);
+		RenderCommand::SetDepthWriteEnabled(true);
 	}
 
 	float Renderer2D::GetLineWidth()
@@ -493,34 +1230,319 @@ namespace Hazel {
 		s_Data.LineWidth = width;
 	}
 
+	void Renderer2D::SetSortingEnabled(bool enabled)
+	{
+		s_Data.SortingEnabled = enabled;
+	}
+
+	bool Renderer2D::IsSortingEnabled()
+	{
+		return s_Data.SortingEnabled;
+	}
+
+	void Renderer2D::SetSpriteAtlasEnabled(bool enabled)
+	{
+		s_Data.SpriteAtlasEnabled = enabled;
+	}
+
+	bool Renderer2D::IsSpriteAtlasEnabled()
+	{
+		return s_Data.SpriteAtlasEnabled;
+	}
+
+	void Renderer2D::SetTextureArraysEnabled(bool enabled)
+	{
+		s_Data.SpriteArraysEnabled = enabled;
+	}
+
+	bool Renderer2D::IsTextureArraysEnabled()
+	{
+		return s_Data.SpriteArraysEnabled;
+	}
+
+	uint32_t Renderer2D::GetTextureArrayCount()
+	{
+		return s_Data.SpriteArrays.GetArrayCount();
+	}
+
+	bool Renderer2D::IsBindlessTexturesEnabled()
+	{
+		return s_Data.Bindless;
+	}
+
+	uint32_t Renderer2D::GetSpriteAtlasPageCount()
+	{
+		return s_Data.SpriteAtlas.GetPageCount();
+	}
+
+	void Renderer2D::SetSortLayer(uint8_t layer)
+	{
+		s_Data.Queue.SetLayer(layer);
+	}
+
+	const Renderer2DSpecification& Renderer2D::GetSpecification()
+	{
+		return s_Data.Specification;
+	}
+
 	void Renderer2D::ResetStats()
 	{
 		memset(&s_Data.Stats, 0, sizeof(Statistics));
 	}
 
+	void Renderer2D::AddCullingStats(uint32_t drawnCount, uint32_t culledCount)
+	{
+		s_Data.Stats.DrawnCount += drawnCount;
+		s_Data.Stats.CulledCount += culledCount;
+	}
+
 	Hazel::Renderer2D::Statistics Renderer2D::GetStats()
 	{
 		return s_Data.Stats;
 	}
 
-	void Renderer2D::StartBatch()
+	void Renderer2D::SubmitQuads(const glm::mat4* transforms, uint32_t count, QuadInstanceAttributes attributes, const Ref<Texture>& texture)
 	{
-		s_Data.QuadIndexCount = 0;
-		s_Data.QuadVertexBufferPtr = s_Data.QuadVertexBufferBase;
+		if (s_Data.Sorting)
+		{
+			s_Data.Queue.SubmitQuads(transforms, count, attributes, texture);
+			return;
+		}
 
-		s_Data.CircleIndexCount = 0;
-		s_Data.CircleVertexBufferPtr = s_Data.CircleVertexBufferBase;
+		while (count)
+		{
+			// 达到当前批次绘制的最大值，重置状态，重新绘制
+			if (s_Data.QuadInstanceCount >= s_Data.MaxQuads)
+				NextQuadBatch();
 
-		s_Data.LineVertexCount = 0;
-		s_Data.LineVertexBufferPtr = s_Data.LineVertexBufferBase;
+			// 纹理槽被清空后需要重新获取
+			uint32_t slot = texture ? GetTextureSlot(texture, attributes.TexIndex & QuadInstance::TexArrayFlag) : 0; // 0 = White Texture
+			attributes.TexIndex = (attributes.TexIndex & ~QuadInstance::TexIndexMask) | slot;
 
-		s_Data.TextureSlotIndex = 1;
+			uint32_t batchCount = std::min(count, s_Data.MaxQuads - s_Data.QuadInstanceCount);
+			QuadInstanceKernel::StreamQuads(s_Data.QuadInstanceBufferPtr, transforms, batchCount, attributes);
+
+			s_Data.QuadInstanceBufferPtr += batchCount;
+			s_Data.QuadInstanceCount += batchCount;
+			s_Data.Stats.QuadCount += batchCount;
+
+			transforms += batchCount;
+			count -= batchCount;
+		}
+	}
+
+	uint32_t Renderer2D::GetTextureSlot(const Ref<Texture>& texture, bool array)
+	{
+		// 纹理在当前批次中已经绑定过，直接返回缓存的槽位
+		if (texture->m_BatchGeneration == s_Data.BatchGeneration)
+			return texture->m_BatchSlot;
+
+		if (array)
+		{
+			if (s_Data.TextureArraySlotIndex >= Renderer2DData::MaxTextureArraySlots)
+				NextTextureBatch();
+
+			uint32_t index = s_Data.TextureArraySlotIndex++;
+			s_Data.TextureArraySlots[index] = texture;
+
+			texture->m_BatchGeneration = s_Data.BatchGeneration;
+			texture->m_BatchSlot = Renderer2DData::MaxTextureSlots + index;
+			return texture->m_BatchSlot;
+		}
+
+		// 如果没有则新增数据
+		// 纹理插槽以达到当前最大值
+		if (s_Data.TextureSlotIndex >= s_Data.TextureSlotCapacity)
+			NextTextureBatch();
+
+		uint32_t slot = s_Data.TextureSlotIndex++;
+		s_Data.TextureSlots[slot] = texture;
+
+		if (s_Data.Bindless)
+		{
+			// 加载失败的纹理没有句柄，按白色纹理绘制
+			uint64_t handle = texture->GetBindlessHandle();
+			s_Data.TextureHandles[slot] = handle ? handle : s_Data.TextureHandles[0];
+		}
+
+		texture->m_BatchGeneration = s_Data.BatchGeneration;
+		texture->m_BatchSlot = slot;
+		return slot;
 	}
 
-	void Renderer2D::NextBatch()
+	void Renderer2D::FlushQueue()
 	{
+		HZ_PROFILE_FUNCTION();
+
+		RenderQueue2D& queue = s_Data.Queue;
+		if (queue.IsEmpty())
+			return;
+
+		const RenderQueue2D::BatchLimits limits = {
+			s_Data.MaxQuads,
+			s_Data.MaxCircles,
+			s_Data.MaxLines,
+			s_Data.TextureSlotCapacity - 1
+		};
+
+		// 排序前命令保持提交顺序，先统计按提交顺序合批时的中断次数作为对比
+		uint32_t submissionBreaks = queue.CountBatchBreaks(limits);
+		queue.Sort();
+		uint32_t sortedBreaks = queue.CountBatchBreaks(limits);
+
+		s_Data.Stats.SortedCommands += (uint32_t)queue.GetCommands().size();
+		s_Data.Stats.BatchBreaksAvoided += (int32_t)submissionBreaks - (int32_t)sortedBreaks;
+
+		// 同一批次内 Quad、Circle、Line 各自一次绘制调用，按排序后的顺序写入各自的实例数组
+		const QuadInstance* quads = queue.GetQuads().data();
+		const CircleInstance* circles = queue.GetCircles().data();
+		const LineInstance* lines = queue.GetLines().data();
+
+		// 每一层先画不透明图元再画半透明图元，通道切换时先把之前的批次按原来的状态绘制完
+		// 保留缓存属于第 0 层的不透明图元，在第 0 层的不透明命令之后、第一条其它命令之前绘制
+		bool translucent = RenderQueue2D::IsTranslucent(queue.GetCommands().front().Key);
+		SetTranslucentState(translucent);
+		for (const RenderQueue2D::Command& command : queue.GetCommands())
+		{
+			const bool commandTranslucent = RenderQueue2D::IsTranslucent(command.Key);
+			const bool drawRetained = !s_Data.RetainedBatches.empty() && (commandTranslucent || RenderQueue2D::GetKeyLayer(command.Key) > 0);
+			if (commandTranslucent != translucent || drawRetained)
+			{
+				Flush();
+				StartBatch();
+				DrawPendingRetained();
+
+				translucent = commandTranslucent;
+				SetTranslucentState(translucent);
+			}
+
+			switch (command.Type)
+			{
+				case RenderQueue2D::Primitive::Quad:
+				{
+					if (s_Data.QuadInstanceCount >= s_Data.MaxQuads)
+						NextQuadBatch();
+
+					const QuadInstance& src = quads[command.Index];
+					uint32_t textureIndex = src.TexIndex & QuadInstance::TexIndexMask;
+					uint32_t slot = textureIndex ? GetTextureSlot(queue.GetTexture(textureIndex), src.TexIndex & QuadInstance::TexArrayFlag) : 0; // 0 = White Texture
+
+					*s_Data.QuadInstanceBufferPtr = src;
+					s_Data.QuadInstanceBufferPtr->TexIndex = (src.TexIndex & ~QuadInstance::TexIndexMask) | slot;
+					s_Data.QuadInstanceBufferPtr++;
+					s_Data.QuadInstanceCount++;
+					s_Data.Stats.QuadCount++;
+					if (!translucent)
+						s_Data.Stats.OpaqueQuadCount++;
+					break;
+				}
+				case RenderQueue2D::Primitive::Circle:
+				{
+					if (s_Data.CircleInstanceCount >= s_Data.MaxCircles)
+						NextCircleBatch();
+
+					*s_Data.CircleInstanceBufferPtr = circles[command.Index];
+					s_Data.CircleInstanceBufferPtr++;
+					s_Data.CircleInstanceCount++;
+					s_Data.Stats.QuadCount++;
+					break;
+				}
+				case RenderQueue2D::Primitive::Line:
+				{
+					if (s_Data.LineInstanceCount >= s_Data.MaxLines)
+						NextLineBatch();
+
+					*s_Data.LineInstanceBufferPtr = lines[command.Index];
+					s_Data.LineInstanceBufferPtr++;
+					s_Data.LineInstanceCount++;
+					break;
+				}
+			}
+		}
+
+		// 最后一段按当前状态绘制完，再恢复默认的混合与深度写入，否则之后的 Clear 无法清除深度
 		Flush();
 		StartBatch();
+		RenderCommand::SetBlendEnabled(true);
+		RenderCommand::SetDepthWriteEnabled(true);
+
+		queue.Reset();
+	}
+
+	void Renderer2D::StartBatch()
+	{
+		StartQuadBatch();
+		ResetTextureSlots();
+		StartCircleBatch();
+		StartLineBatch();
+	}
+
+	void Renderer2D::StartQuadBatch()
+	{
+		// 每个批次在环形缓冲中重新预留整批容量，GPU 还在读取的区域会等待其完成
+		s_Data.QuadInstanceCount = 0;
+		s_Data.QuadInstanceBufferBase = (QuadInstance*)s_Data.QuadInstanceBuffer->Reserve(s_Data.MaxQuads * sizeof(QuadInstance));
+		s_Data.QuadInstanceBufferPtr = s_Data.QuadInstanceBufferBase;
+	}
+
+	void Renderer2D::StartCircleBatch()
+	{
+		s_Data.CircleInstanceCount = 0;
+		s_Data.CircleInstanceBufferBase = (CircleInstance*)s_Data.CircleInstanceBuffer->Reserve(s_Data.MaxCircles * sizeof(CircleInstance));
+		s_Data.CircleInstanceBufferPtr = s_Data.CircleInstanceBufferBase;
+	}
+
+	void Renderer2D::StartLineBatch()
+	{
+		s_Data.LineInstanceCount = 0;
+		s_Data.LineInstanceBufferBase = (LineInstance*)s_Data.LineInstanceBuffer->Reserve(s_Data.MaxLines * sizeof(LineInstance));
+		s_Data.LineInstanceBufferPtr = s_Data.LineInstanceBufferBase;
+	}
+
+	void Renderer2D::ResetTextureSlots()
+	{
+		s_Data.TextureSlotIndex = 1;
+		s_Data.TextureArraySlotIndex = 0;
+
+		// 递增编号后，所有纹理上缓存的槽位自动失效
+		s_Data.BatchGeneration++;
+		s_Data.WhiteTexture->m_BatchGeneration = s_Data.BatchGeneration;
+		s_Data.WhiteTexture->m_BatchSlot = 0;
+	}
+
+	// 每种图元单独 Flush，一种图元的容量或纹理槽用完时不影响其它图元的批次
+	// 容量用完的批次先不绘制，攒到 MaxPendingBatches 个后与之前的批次一起用一次 MultiDraw 画出
+	void Renderer2D::NextQuadBatch()
+	{
+		FlushQuads();
+		if (s_Data.QuadCommands.size() >= Renderer2DData::MaxPendingBatches)
+			ExecuteQuads();
+		StartQuadBatch();
+	}
+
+	void Renderer2D::NextCircleBatch()
+	{
+		FlushCircles();
+		if (s_Data.CircleCommands.size() >= Renderer2DData::MaxPendingBatches)
+			ExecuteCircles();
+		StartCircleBatch();
+	}
+
+	void Renderer2D::NextLineBatch()
+	{
+		FlushLines();
+		if (s_Data.LineCommands.size() >= Renderer2DData::MaxPendingBatches)
+			ExecuteLines();
+		StartLineBatch();
+	}
+
+	void Renderer2D::NextTextureBatch()
+	{
+		// 等待中的批次引用的是当前纹理槽，必须在清空之前画出
+		FlushQuads();
+		ExecuteQuads();
+		StartQuadBatch();
+		ResetTextureSlots();
 	}
 
 }
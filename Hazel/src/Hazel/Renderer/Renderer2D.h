@@ -3,16 +3,105 @@
 #include "Hazel/Renderer/OrthographicCamera.h"
 
 #include "Hazel/Renderer/Texture.h"
+#include "Hazel/Renderer/SubTexture2D.h"
 #include "Hazel/Renderer/Camera.h"
 #include "Hazel/Renderer/EditorCamera.h"
 #include "Hazel/Scene/Components.h"
+#include "Hazel/Renderer/QuadInstanceKernel.h"
 
 namespace Hazel {
 
+	class VertexArray;
+	class VertexBuffer;
+
+	/**
+	* 每个 Quad 一条实例数据（64 字节），四个角由顶点着色器根据 gl_VertexIndex 展开：
+	* 角 = Translation + (±0.5) * AxisX + (±0.5) * AxisY
+	* AxisX / AxisY / Translation 分别对应 transform 的第 0、1、3 列，保持 32 位浮点精度，
+	* 其余属性使用压缩格式：RGBA8 颜色，半精度纹理坐标与平铺系数，纹理槽与标志位共用一个整数
+	*/
+	struct QuadInstance
+	{
+		/**
+		* TexIndex 低 16 位为纹理槽（线程批次中为局部纹理索引），
+		* 16 ~ 27 位为纹理数组的层，最高位表示纹理是纹理数组，其余位留作标志位
+		*/
+		static constexpr uint32_t TexIndexMask = 0xffff;
+		static constexpr uint32_t TexLayerShift = 16;
+		static constexpr uint32_t TexLayerMask = 0xfff << TexLayerShift;
+		static constexpr uint32_t TexArrayFlag = 1u << 31;
+
+		glm::vec3 AxisX;
+
+		// Editor-only
+		int EntityID;
+
+		glm::vec3 AxisY;
+		uint32_t Color; // RGBA8
+		glm::vec3 Translation;
+		uint32_t TexIndex;
+		uint16_t TexRect[4]; // half，xy = 左下角纹理坐标，zw = 右上角纹理坐标
+		uint16_t TilingFactor; // half
+		uint16_t Padding[3];
+	};
+
+	struct CircleInstance
+	{
+		glm::vec3 AxisX;
+
+		// Editor-only
+		int EntityID;
+
+		glm::vec3 AxisY;
+		uint32_t Color; // RGBA8
+		glm::vec3 Translation;
+		uint16_t Thickness; // half
+		uint16_t Fade; // half
+	};
+
+	/**
+	* 每条线段一条实例数据，顶点着色器在屏幕空间把线段展开成宽 Width 像素的矩形，
+	* 两端各延长半个线宽（方形端点），矩形轮廓与折线的拐角因此没有缺口
+	*/
+	struct LineInstance
+	{
+		glm::vec3 P0;
+
+		// Editor-only
+		int EntityID;
+
+		glm::vec3 P1;
+		uint32_t Color; // RGBA8
+		float Width; // 像素
+	};
+
+	struct Renderer2DSpecification
+	{
+		/** 每种图元单个批次（一次绘制调用）的初始容量 */
+		uint32_t QuadCapacity = 20000;
+		uint32_t CircleCapacity = 2000;
+		uint32_t LineCapacity = 10000; // 线段数
+
+		/**
+		* 一个场景中某种图元的数量超过批次容量时，下一个场景开始前按该系数扩大这种图元的容量，
+		* 直到能容纳整个场景或达到上限。为 1 时不增长，超出容量只会拆分成多个批次。
+		*/
+		float GrowthFactor = 2.0f;
+		uint32_t MaxQuadCapacity = 200000;
+		uint32_t MaxCircleCapacity = 100000;
+		uint32_t MaxLineCapacity = 100000;
+
+		/**
+		* 驱动支持时使用无绑定纹理：Quad 通过句柄表采样纹理，一个批次可以引用的纹理数量不再受 32 个纹理槽限制。
+		* 不支持时自动退回到纹理槽绑定。
+		*/
+		bool BindlessTextures = true;
+	};
+
 	class Renderer2D
 	{
 	public:
-		static void Init();
+		static void Init(const Renderer2DSpecification& specification = Renderer2DSpecification());
 		static void Shutdown();
 
 		static void BeginScene(const Camera& camera, const glm::mat4& transform);
@@ -27,8 +116,17 @@ namespace Hazel {
 		static void DrawQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f));
 		static void DrawQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f));
 
+		static void DrawQuad(const glm::vec2& position, const glm::vec2& size, const Ref<SubTexture2D>& subTexture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f));
+		static void DrawQuad(const glm::vec3& position, const glm::vec2& size, const Ref<SubTexture2D>& subTexture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f));
+
 		static void DrawQuad(const glm::mat4& transform, const glm::vec4& color, int entityID = -1);
 		static void DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f), int entityID = -1);
+		/** 平铺系数作用在整张纹理的坐标上，子纹理位于图集中时应保持为 1 */
+		static void DrawQuad(const glm::mat4& transform, const Ref<SubTexture2D>& subTexture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f), int entityID = -1);
+
+		/** 批量绘制共用颜色/纹理的 Quad，每批次只做一次状态检查 */
+		static void DrawQuads(const glm::mat4* transforms, uint32_t count, const glm::vec4& color, int entityID = -1);
+		static void DrawQuads(const glm::mat4* transforms, uint32_t count, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f), int entityID = -1);
 
 		static void DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color);
 		static void DrawRotatedQuad(const glm::vec3& position, const glm::vec2& size, float rotation, const glm::vec4& color);
@@ -44,24 +142,207 @@ namespace Hazel {
 
 		static void DrawSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
 
+		/**
+		* 工作线程私有的批次缓存
+		* 每个线程只写入自己的实例数组与局部纹理槽，不会访问 Renderer2D 的全局批次数据，
+		* 填充完成后由渲染线程调用 Renderer2D::Submit 合并到当前批次中。
+		*/
+		class ThreadBatch
+		{
+		public:
+			void DrawQuad(const glm::mat4& transform, const glm::vec4& color, int entityID = -1);
+			void DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f), int entityID = -1);
+			void DrawQuad(const glm::mat4& transform, const Ref<SubTexture2D>& subTexture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f), int entityID = -1);
+			void DrawCircle(const glm::mat4& transform, const glm::vec4& color, float thickness = 1.0f, float fade = 0.005f, int entityID = -1);
+			void DrawLine(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color, int entityID = -1);
+			void DrawSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
+
+			/** 清空已记录的数据，保留已分配的内存以便下一帧复用 */
+			void Reset();
+
+			uint32_t GetQuadCount() const { return (uint32_t)m_QuadInstances.size(); }
+		private:
+			/** 返回 texture 在本批次中的局部索引（0 为白色纹理） */
+			uint32_t GetLocalTextureIndex(const Ref<Texture>& texture);
+		private:
+			std::vector<QuadInstance> m_QuadInstances;
+			std::vector<CircleInstance> m_CircleInstances;
+			std::vector<LineInstance> m_LineInstances;
+
+			/** 局部纹理槽，m_Textures[i] 对应局部索引 i + 1，纹理数组由实例的 TexArrayFlag 标记 */
+			std::vector<Ref<Texture>> m_Textures;
+
+			friend class Renderer2D;
+		};
+
+		/**
+		* 将工作线程填充好的批次合并到当前批次中，只能在渲染线程调用
+		* 合并时重新映射纹理索引，纹理槽或顶点数量超出上限时会自动 Flush
+		*/
+		static void Submit(ThreadBatch& batch);
+
+		/**
+		* 保留模式的 Quad 实例缓存，只保存不透明的精灵
+		* 每个槽位保存一个生成好的实例，GPU 上的副本常驻，内容不变的槽位不再重新计算与上传，
+		* 只有修改过的槽位区间在下一次 DrawRetained 时上传。
+		* 不透明图元写入深度，绘制顺序不影响结果，可以整体一次画出；半透明精灵需要按深度与其它图元排序，不放入缓存。
+		* 缓存有自己的纹理表，最多引用 MaxTextures 张纹理，与白色纹理一起在一次绘制调用中绑定。
+		* 只能在渲染线程使用。
+		*/
+		class RetainedBatch
+		{
+		public:
+			static constexpr uint32_t MaxTextures = 23; // 槽位 0 为白色纹理，24 ~ 31 留给纹理数组
+			static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+			void Free(uint32_t slot);
+
+			/**
+			* 重新生成槽位中的实例，与 Renderer2D::DrawSprite 相同，小纹理会被打包进图集（不使用纹理数组）
+			* slot 为 InvalidSlot 时分配新槽位
+			* 精灵半透明（与排序队列的判断相同）或纹理表已满时释放该槽位（slot 置为 InvalidSlot）并返回 false，
+			* 调用者应改为逐帧绘制这个精灵
+			*/
+			bool SetSprite(uint32_t& slot, const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
+
+			/** 有内容的槽位数量 */
+			uint32_t GetCount() const { return m_Count; }
+		private:
+			/** 分配一个空槽位，空槽位不绘制任何内容 */
+			uint32_t Allocate();
+			void ClearSlot(uint32_t slot);
+			void MarkDirty(uint32_t slot);
+
+			/** 返回纹理在纹理表中的索引（从 1 开始），纹理表已满时返回 0 */
+			uint32_t AcquireTexture(const Ref<Texture2D>& texture);
+			void ReleaseTexture(uint32_t index);
+
+			/** 上传修改过的槽位，槽位数量超过 GPU 缓冲容量时重新创建缓冲并整体上传 */
+			void Upload();
+		private:
+			std::vector<QuadInstance> m_Instances;
+			std::vector<bool> m_Occupied;
+			std::vector<uint32_t> m_FreeSlots;
+			uint32_t m_Count = 0;
+
+			std::vector<uint32_t> m_DirtySlots;
+			std::vector<bool> m_Dirty;
+
+			std::array<Ref<Texture2D>, MaxTextures> m_Textures;
+			std::array<uint32_t, MaxTextures> m_TextureRefCounts = {};
+
+			Ref<VertexArray> m_VertexArray;
+			Ref<VertexBuffer> m_InstanceBuffer;
+			uint32_t m_Capacity = 0;
+
+			friend class Renderer2D;
+		};
+
+		/**
+		* 上传保留缓存中修改过的部分，并用一次绘制调用画出全部槽位，需要在 BeginScene / EndScene 之间调用
+		* 缓存视为第 0 层的不透明图元：开启排序时在第 0 层的不透明命令之后绘制，否则立即绘制
+		*/
+		static void DrawRetained(RetainedBatch& batch);
+
+		/** 之后绘制的线段的宽度（像素），每条线段单独记录，改变线宽不会中断批次 */
 		static float GetLineWidth();
 		static void SetLineWidth(float width);
 
+		/**
+		* 开启后，BeginScene 与 EndScene 之间的绘制先记录到排序队列中，
+		* EndScene 时按（层、混合方式、着色器、纹理、深度）排序后再合批，减少批次中断，
+		* 半透明图元按由远到近的顺序绘制。在下一次 BeginScene 时生效。
+		*/
+		static void SetSortingEnabled(bool enabled);
+		static bool IsSortingEnabled();
+		/**
+		* 开启后，DrawSprite 会把平铺系数为 1、从文件加载的小纹理自动打包进运行时图集，
+		* 大量不同的精灵图片只占用少数几个纹理槽。默认开启。
+		*/
+		static void SetSpriteAtlasEnabled(bool enabled);
+		/** 是否正在使用无绑定纹理，取决于 Renderer2DSpecification::BindlessTextures 与驱动支持 */
+		static bool IsBindlessTexturesEnabled();
+		static bool IsSpriteAtlasEnabled();
+		static uint32_t GetSpriteAtlasPageCount();
+		/**
+		* 开启后，DrawSprite 会把尺寸与格式相同、从文件加载的纹理放进共享的纹理数组，
+		* 同一个数组中的纹理只占用一个纹理槽，平铺的纹理同样适用。默认开启，无绑定纹理模式下不需要。
+		*/
+		static void SetTextureArraysEnabled(bool enabled);
+		static bool IsTextureArraysEnabled();
+		static uint32_t GetTextureArrayCount();
+
+		/** 之后提交的图元所在的层，层号小的先绘制，每次 BeginScene 时重置为 0 */
+		static void SetSortLayer(uint8_t layer);
+
 		// Stats
 		struct Statistics
 		{
 			uint32_t DrawCalls = 0;
+			/** 绘制的批次数，同一种图元的多个批次用一次 MultiDraw 调用画出，因此可能多于 DrawCalls */
+			uint32_t Batches = 0;
 			uint32_t QuadCount = 0;
 
-			uint32_t GetTotalVertexCount() const { return QuadCount * 4; }
-			uint32_t GetTotalIndexCount() const { return QuadCount * 6; }
+			/** 经过排序队列的命令数量，以及排序相对提交顺序减少的批次中断次数 */
+			uint32_t SortedCommands = 0;
+			int32_t BatchBreaksAvoided = 0;
+			/** 排序队列中按不透明通道（不混合、写入深度）绘制的 Quad 数量 */
+			uint32_t OpaqueQuadCount = 0;
+
+			/** 场景绘制时通过视锥剔除的实体数量，以及被剔除的实体数量 */
+			uint32_t DrawnCount = 0;
+			uint32_t CulledCount = 0;
+
+			/** 每个实例由顶点着色器展开成两个三角形，共 6 个顶点 */
+			uint32_t GetTotalVertexCount() const { return QuadCount * 6; }
+			uint32_t GetTotalInstanceCount() const { return QuadCount; }
 		};
+		static const Renderer2DSpecification& GetSpecification();
+
 		static void ResetStats();
+		/** 由场景在剔除后记录 */
+		static void AddCullingStats(uint32_t drawnCount, uint32_t culledCount);
 		static Statistics GetStats();
 
 	private:
 		static void StartBatch();
-		static void NextBatch();
+		static void StartQuadBatch();
+		static void StartCircleBatch();
+		static void StartLineBatch();
+
+		/** 清空纹理槽，只保留 0 号白色纹理 */
+		static void ResetTextureSlots();
+
+		/** 提交当前批次的实例数据，记录一条等待执行的绘制命令 */
+		static void FlushQuads();
+		static void FlushCircles();
+		static void FlushLines();
+
+		/** 用一次绘制调用画出一种图元全部等待中的批次 */
+		static void ExecuteQuads();
+		static void ExecuteCircles();
+		static void ExecuteLines();
+
+		/** 只 Flush 一种图元并为它开启新批次，其它图元的批次不受影响 */
+		static void NextQuadBatch();
+		static void NextCircleBatch();
+		static void NextLineBatch();
+		/** 纹理槽已满：画出等待中的 Quad 批次，清空纹理槽后开启新批次 */
+		static void NextTextureBatch();
+
+		/** 对排序队列中的命令排序，并按排序后的顺序写入批次 */
+		static void FlushQueue();
+		/** 按不透明通道的状态画出等待中的保留缓存 */
+		static void DrawPendingRetained();
+
+		/** 将 count 个 Quad 写入当前批次，容量不足时自动开启新批次，texture 为空时使用白色纹理 */
+		static void SubmitQuads(const glm::mat4* transforms, uint32_t count, QuadInstanceAttributes attributes, const Ref<Texture>& texture = nullptr);
+
+		/**
+		* 返回 texture 在当前批次中的纹理槽，没有空闲槽位时会清空纹理槽并开启新批次
+		* @param array texture 是否为纹理数组，纹理数组使用单独的一组纹理槽
+		*/
+		static uint32_t GetTextureSlot(const Ref<Texture>& texture, bool array = false);
 	};
 
 }
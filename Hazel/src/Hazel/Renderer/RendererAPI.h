@@ -22,7 +22,15 @@ namespace Hazel {
 
 		virtual void Init() = 0;
 		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+		/** 当前的视口，Framebuffer::Bind 等直接修改视口的调用同样会反映在这里 */
+		virtual void GetViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) = 0;
+		/** 是否支持无绑定纹理，着色器可以通过句柄直接采样任意数量的纹理 */
+		virtual bool SupportsBindlessTextures() const = 0;
 		virtual void SetClearColor(const glm::vec4& color) = 0;
+
+		/** 默认开启混合（SRC_ALPHA, ONE_MINUS_SRC_ALPHA）与深度写入，修改后需要恢复，否则 Clear 无法清除深度 */
+		virtual void SetBlendEnabled(bool enabled) = 0;
+		virtual void SetDepthWriteEnabled(bool enabled) = 0;
 		virtual void Clear() = 0;
 
 		/**
@@ -30,9 +38,18 @@ namespace Hazel {
 		*/
 		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) = 0;
 
-		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) = 0;
+		/**
+		* 实例化绘制三角形，不使用索引缓冲
+		* @param vertexCount 每个实例的顶点数
+		* @param instanceCount 实例数量
+		* @param baseInstance 从实例缓冲中的第几个实例开始读取
+		*/
+		virtual void DrawInstanced(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t instanceCount, uint32_t baseInstance = 0) = 0;
 
-		virtual void SetLineWidth(float width) = 0;
+		/**
+		* 用一次调用执行 indirectBuffer 中的全部实例化绘制命令，各命令共用 VAO、着色器与纹理绑定
+		*/
+		virtual void MultiDrawInstancedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer) = 0;
 
 		inline static API GetAPI() { return s_API; }
 	private:
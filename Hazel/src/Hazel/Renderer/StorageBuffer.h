@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Hazel/Core/Base.h"
+
+namespace Hazel {
+
+	/**
+	* SSBO (着色器存储缓冲，Shader Storage Buffer Object)
+	* 与 UniformBuffer 用法相同，但容量不受 16KB/64KB 限制，按 std430 紧密排列
+	*/
+	class StorageBuffer
+	{
+	public:
+		virtual ~StorageBuffer() {}
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
+		static Ref<StorageBuffer> Create(uint32_t size, uint32_t binding);
+	};
+
+}
@@ -0,0 +1,19 @@
+#include "hzpch.h"
+#include "Hazel/Renderer/SubTexture2D.h"
+
+namespace Hazel {
+
+	SubTexture2D::SubTexture2D(const Ref<Texture2D>& texture, const glm::vec2& min, const glm::vec2& max)
+		: m_Texture(texture), m_TexRect(min.x, min.y, max.x, max.y)
+	{
+	}
+
+	Ref<SubTexture2D> SubTexture2D::CreateFromCoords(const Ref<Texture2D>& texture, const glm::vec2& coords, const glm::vec2& cellSize, const glm::vec2& spriteSize)
+	{
+		glm::vec2 textureSize = { (float)texture->GetWidth(), (float)texture->GetHeight() };
+		glm::vec2 min = coords * cellSize / textureSize;
+		glm::vec2 max = (coords + spriteSize) * cellSize / textureSize;
+		return CreateRef<SubTexture2D>(texture, min, max);
+	}
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Hazel/Renderer/Texture.h"
+
+#include <glm/glm.hpp>
+
+namespace Hazel {
+
+	/** 纹理中的一块矩形区域，用于图集与精灵表 */
+	class SubTexture2D
+	{
+	public:
+		/** min / max 为左下角与右上角的纹理坐标 */
+		SubTexture2D(const Ref<Texture2D>& texture, const glm::vec2& min, const glm::vec2& max);
+
+		const Ref<Texture2D>& GetTexture() const { return m_Texture; }
+
+		/** xy = 左下角纹理坐标，zw = 右上角纹理坐标，与 QuadInstanceAttributes::TexRect 一致 */
+		const glm::vec4& GetTexRect() const { return m_TexRect; }
+
+		/**
+		* 从按网格排列的精灵表中取出一块
+		* @param coords 以格子为单位的左下角坐标
+		* @param cellSize 每个格子的像素大小
+		* @param spriteSize 以格子为单位的大小
+		*/
+		static Ref<SubTexture2D> CreateFromCoords(const Ref<Texture2D>& texture, const glm::vec2& coords, const glm::vec2& cellSize, const glm::vec2& spriteSize = { 1.0f, 1.0f });
+	private:
+		Ref<Texture2D> m_Texture;
+		glm::vec4 m_TexRect;
+	};
+
+}
@@ -6,6 +6,11 @@
 
 namespace Hazel {
 
+	enum class TextureFormat
+	{
+		None = 0, RGB8, RGBA8
+	};
+
 	class Texture
 	{
 	public:
@@ -14,14 +19,43 @@ namespace Hazel {
 		virtual uint32_t GetWidth() const = 0;
 		virtual uint32_t GetHeight() const = 0;
 		virtual uint32_t GetRendererID() const = 0;
+		virtual TextureFormat GetFormat() const = 0;
+
+		/** 从文件加载的纹理返回文件路径，运行时创建的纹理为空 */
+		virtual const std::string& GetPath() const = 0;
 
 		virtual void SetData(void* data, uint32_t size) = 0;
+		/** 更新 (x, y) 处 width * height 的区域，数据格式与纹理一致 */
+		virtual void SetData(void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+		/** 以 RGBA8 格式读回整张纹理，size 需要等于 width * height * 4 */
+		virtual void GetData(void* data, uint32_t size) const = 0;
 
 		virtual void Bind(uint32_t slot = 0) const = 0;
 
+		/**
+		* 无绑定纹理的 64 位句柄，第一次调用时创建并使纹理常驻显存，之后不能再修改采样参数
+		* 只能在 RenderCommand::SupportsBindlessTextures 为 true 时调用
+		*/
+		virtual uint64_t GetBindlessHandle() const = 0;
+
 		virtual bool IsLoaded() const = 0;
 
+		/**
+		* 是否含有 alpha < 255 的像素，在加载或写入数据时计算
+		* Renderer2D 据此把 Quad 分到不透明通道（深度写入、不混合）或半透明通道
+		*/
+		virtual bool HasTransparency() const = 0;
+
 		virtual bool operator==(const Texture& other) const = 0;
+	private:
+		/**
+		* Renderer2D 批次内的纹理槽缓存
+		* m_BatchGeneration 与 Renderer2D 当前批次编号一致时 m_BatchSlot 有效，查找无需遍历纹理槽
+		*/
+		uint32_t m_BatchGeneration = 0;
+		uint32_t m_BatchSlot = 0;
+
+		friend class Renderer2D;
 	};
 
 	class Texture2D : public Texture
@@ -31,4 +65,24 @@ namespace Hazel {
 		static Ref<Texture2D> Create(const std::string& path);
 	};
 
+	/**
+	* 尺寸与格式相同的一组纹理，着色器中用 sampler2DArray 按层采样，整个数组只占用一个纹理槽
+	* SetData / GetData 针对全部层，数据按层依次排列
+	*/
+	class Texture2DArray : public Texture
+	{
+	public:
+		virtual uint32_t GetLayerCount() const = 0;
+
+		/** 更新第 layer 层 (x, y) 处 width * height 的区域，数据格式与纹理一致；SetData(data, x, y, width, height) 更新第 0 层 */
+		virtual void SetLayerData(uint32_t layer, void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+
+		/** 在 GPU 上把 source 整张复制到第 layer 层，source 的尺寸与格式必须与数组一致 */
+		virtual void CopyLayer(uint32_t layer, const Ref<Texture2D>& source) = 0;
+		/** 在 GPU 上把 source 的前 layerCount 层复制到相同的层，用于扩大层数；尺寸与格式必须一致 */
+		virtual void CopyLayers(const Ref<Texture2DArray>& source, uint32_t layerCount) = 0;
+
+		static Ref<Texture2DArray> Create(uint32_t width, uint32_t height, uint32_t layerCount, TextureFormat format = TextureFormat::RGBA8);
+	};
+
 }
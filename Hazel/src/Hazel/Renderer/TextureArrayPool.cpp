@@ -0,0 +1,178 @@
+#include "hzpch.h"
+#include "Hazel/Renderer/TextureArrayPool.h"
+
+namespace Hazel {
+
+	TextureArrayPool::TextureArrayPool(const TextureArrayPoolSpecification& specification)
+		: m_Specification(specification)
+	{
+	}
+
+	bool TextureArrayPool::Add(const Ref<Texture2D>& texture, TextureArrayLayer& outLayer)
+	{
+		if (!texture->IsLoaded() || texture->GetFormat() == TextureFormat::None)
+			return false;
+
+		if (texture->GetWidth() > m_Specification.MaxTextureSize || texture->GetHeight() > m_Specification.MaxTextureSize)
+			return false;
+
+		auto [it, inserted] = m_Entries.try_emplace(texture.get());
+		Entry& entry = it->second;
+		if (inserted || entry.Source.lock() != texture)
+		{
+			// 旧纹理已经释放、地址被新纹理复用，先归还旧纹理的层
+			if (!inserted)
+				Release(entry);
+
+			entry.Source = texture;
+			entry.BucketKey = GetBucketKey(*texture);
+			entry.Layer = {};
+			entry.Rejected = false;
+			m_Buckets[entry.BucketKey].TextureCount++;
+		}
+
+		if (!entry.Layer.Array)
+		{
+			Bucket& bucket = m_Buckets[entry.BucketKey];
+			if (entry.Rejected || bucket.TextureCount < m_Specification.MinTexturesPerBucket)
+				return false;
+
+			if (!Allocate(bucket, texture, entry.Layer))
+			{
+				entry.Rejected = true;
+				return false;
+			}
+		}
+
+		outLayer = entry.Layer;
+		return true;
+	}
+
+	bool TextureArrayPool::Find(const Ref<Texture2D>& texture, TextureArrayLayer& outLayer) const
+	{
+		auto it = m_Entries.find(texture.get());
+		if (it == m_Entries.end() || !it->second.Layer.Array || it->second.Source.expired())
+			return false;
+
+		outLayer = it->second.Layer;
+		return true;
+	}
+
+	void TextureArrayPool::Clear()
+	{
+		m_Buckets.clear();
+		m_Entries.clear();
+		m_ArrayCount = 0;
+		m_TextureCount = 0;
+	}
+
+	uint64_t TextureArrayPool::GetBucketKey(const Texture2D& texture)
+	{
+		return ((uint64_t)texture.GetWidth() << 32) | ((uint64_t)texture.GetHeight() << 8) | ((uint64_t)texture.HasTransparency() << 7) | (uint64_t)texture.GetFormat();
+	}
+
+	bool TextureArrayPool::Allocate(Bucket& bucket, const Ref<Texture2D>& texture, TextureArrayLayer& outLayer)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		// 只有需要新的层时才回收已经释放的纹理，回收会遍历所有条目；bucket 中有当前纹理，不会在回收时被释放
+		if (bucket.FreeLayers.empty() && (bucket.Arrays.empty() || bucket.UsedLayers == bucket.Arrays.back()->GetLayerCount()))
+			ReleaseExpired();
+
+		if (!bucket.FreeLayers.empty())
+		{
+			outLayer = bucket.FreeLayers.back();
+			bucket.FreeLayers.pop_back();
+		}
+		else
+		{
+			if (!bucket.Arrays.empty() && bucket.UsedLayers == bucket.Arrays.back()->GetLayerCount() && bucket.UsedLayers < m_Specification.LayersPerArray)
+				Grow(bucket);
+
+			if (bucket.Arrays.empty() || bucket.UsedLayers == bucket.Arrays.back()->GetLayerCount())
+			{
+				if (m_ArrayCount >= m_Specification.MaxArrays)
+				{
+					HZ_CORE_WARNING("Texture array pool is full ({0} arrays)", m_ArrayCount);
+					return false;
+				}
+
+				uint32_t layerCount = std::min(m_Specification.InitialLayers, m_Specification.LayersPerArray);
+				bucket.Arrays.push_back(Texture2DArray::Create(texture->GetWidth(), texture->GetHeight(), layerCount, texture->GetFormat()));
+				bucket.UsedLayers = 0;
+				m_ArrayCount++;
+			}
+
+			outLayer.Array = bucket.Arrays.back();
+			outLayer.Layer = bucket.UsedLayers++;
+		}
+		outLayer.Array->CopyLayer(outLayer.Layer, texture);
+
+		m_TextureCount++;
+		return true;
+	}
+
+	void TextureArrayPool::Grow(Bucket& bucket)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		const Ref<Texture2DArray> array = bucket.Arrays.back();
+		const uint32_t layerCount = std::min(array->GetLayerCount() * 2, m_Specification.LayersPerArray);
+
+		Ref<Texture2DArray> grown = Texture2DArray::Create(array->GetWidth(), array->GetHeight(), layerCount, array->GetFormat());
+		grown->CopyLayers(array, bucket.UsedLayers);
+		bucket.Arrays.back() = grown;
+
+		for (auto& [key, entry] : m_Entries)
+		{
+			if (entry.Layer.Array == array)
+				entry.Layer.Array = grown;
+		}
+
+		for (TextureArrayLayer& layer : bucket.FreeLayers)
+		{
+			if (layer.Array == array)
+				layer.Array = grown;
+		}
+	}
+
+	void TextureArrayPool::Release(Entry& entry)
+	{
+		auto it = m_Buckets.find(entry.BucketKey);
+		HZ_CORE_ASSERT(it != m_Buckets.end(), "Texture array pool entry has no bucket!");
+
+		Bucket& bucket = it->second;
+		bucket.TextureCount--;
+		if (entry.Layer.Array)
+		{
+			bucket.FreeLayers.push_back(entry.Layer);
+			m_TextureCount--;
+		}
+
+		// 仍在绘制中的批次持有数组的引用，数组在它们结束后才真正销毁
+		if (bucket.TextureCount == 0)
+		{
+			m_ArrayCount -= (uint32_t)bucket.Arrays.size();
+			m_Buckets.erase(it);
+		}
+	}
+
+	void TextureArrayPool::ReleaseExpired()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		for (auto it = m_Entries.begin(); it != m_Entries.end();)
+		{
+			if (it->second.Source.expired())
+			{
+				Release(it->second);
+				it = m_Entries.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+}
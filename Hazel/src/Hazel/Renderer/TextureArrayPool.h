@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Hazel/Renderer/Texture.h"
+
+namespace Hazel {
+
+	struct TextureArrayPoolSpecification
+	{
+		/** 新建纹理数组时的层数，用满后按两倍扩大，直到 LayersPerArray */
+		uint32_t InitialLayers = 4;
+		/** 每个纹理数组最多的层数，同一尺寸的纹理超出后新建一个数组 */
+		uint32_t LayersPerArray = 64;
+		uint32_t MaxArrays = 32;
+		/** 宽或高超过这个值的纹理不放入纹理数组，大纹理单独占用纹理槽的开销相对更小 */
+		uint32_t MaxTextureSize = 512;
+		/** 同一尺寸与格式至少出现这么多张纹理才放入纹理数组，只有一张时单独占用纹理槽更划算 */
+		uint32_t MinTexturesPerBucket = 2;
+	};
+
+	/** 纹理数组中的一层 */
+	struct TextureArrayLayer
+	{
+		Ref<Texture2DArray> Array;
+		uint32_t Layer = 0;
+	};
+
+	/**
+	* 按尺寸与格式分组的纹理数组池
+	* 尺寸与格式完全相同的纹理（精灵表、瓦片集）在显存中复制到同一个 GL_TEXTURE_2D_ARRAY 的不同层，
+	* 绘制时引用（数组，层），同一个数组中的所有纹理只占用一个纹理槽。
+	* 与 TextureAtlas 不同，每层就是整张纹理，平铺（GL_REPEAT）不受影响，也不需要读回 CPU。
+	* 数组从 InitialLayers 层开始，用满后在显存中复制到层数加倍的新数组，显存占用与实际放入的纹理数量成正比。
+	* 纹理池不持有源纹理，精灵不再引用源纹理后它就会被释放；它占用的层在需要新层时回收，留给同一尺寸的纹理复用，
+	* 某个尺寸的纹理全部释放后整个桶的数组一起释放。
+	*/
+	class TextureArrayPool
+	{
+	public:
+		TextureArrayPool(const TextureArrayPoolSpecification& specification = TextureArrayPoolSpecification());
+
+		/**
+		* 返回 texture 所在的层，第一次遇到同一尺寸的第 MinTexturesPerBucket 张纹理时才开始复制
+		* 不能放入纹理数组时返回 false，只能在渲染线程调用
+		* 数组扩大后之前返回的层仍然指向旧数组，旧数组的内容不变，在不再被引用后释放
+		*/
+		bool Add(const Ref<Texture2D>& texture, TextureArrayLayer& outLayer);
+
+		/** 只查找已经放入的纹理，不修改纹理池，可以在多个线程中同时调用 */
+		bool Find(const Ref<Texture2D>& texture, TextureArrayLayer& outLayer) const;
+
+		void Clear();
+
+		uint32_t GetArrayCount() const { return m_ArrayCount; }
+		uint32_t GetTextureCount() const { return m_TextureCount; }
+
+		const TextureArrayPoolSpecification& GetSpecification() const { return m_Specification; }
+	private:
+		/**
+		* 尺寸与格式相同的一组纹理数组，最后一个数组之前的数组都已经用满
+		* 半透明与不透明纹理分到不同的桶，数组的 HasTransparency 与其中每一层一致
+		*/
+		struct Bucket
+		{
+			std::vector<Ref<Texture2DArray>> Arrays;
+			uint32_t UsedLayers = 0; // 最后一个数组中已使用的层数，最后一个数组可能还没有扩大到 LayersPerArray 层
+			uint32_t TextureCount = 0; // 仍然存在的该尺寸纹理数量，包括还没有放入的
+			std::vector<TextureArrayLayer> FreeLayers; // 源纹理已经释放、可以复用的层
+		};
+
+		struct Entry
+		{
+			/** 不持有源纹理，源纹理释放后地址可能被复用，需要重新放入 */
+			std::weak_ptr<Texture2D> Source;
+			uint64_t BucketKey = 0;
+			TextureArrayLayer Layer; // Array 为空表示还没有放入
+			bool Rejected = false; // 纹理池已满，不再尝试
+		};
+
+		static uint64_t GetBucketKey(const Texture2D& texture);
+
+		bool Allocate(Bucket& bucket, const Ref<Texture2D>& texture, TextureArrayLayer& outLayer);
+		/** 把条目占用的层还给所在的桶并减少计数，桶中不再有纹理时释放它的数组；不从 m_Entries 中移除条目 */
+		void Release(Entry& entry);
+		/** 释放源纹理已经被销毁的条目 */
+		void ReleaseExpired();
+		/** 把 bucket 的最后一个数组复制到层数加倍的新数组，并更新引用它的条目 */
+		void Grow(Bucket& bucket);
+	private:
+		TextureArrayPoolSpecification m_Specification;
+
+		std::unordered_map<uint64_t, Bucket> m_Buckets;
+		std::unordered_map<const Texture2D*, Entry> m_Entries;
+
+		uint32_t m_ArrayCount = 0;
+		uint32_t m_TextureCount = 0;
+	};
+
+}
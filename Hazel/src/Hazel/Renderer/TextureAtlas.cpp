@@ -0,0 +1,198 @@
+#include "hzpch.h"
+#include "Hazel/Renderer/TextureAtlas.h"
+
+namespace Hazel {
+
+	SkylinePacker::SkylinePacker(uint32_t width, uint32_t height)
+		: m_Width(width), m_Height(height)
+	{
+		m_Skyline.push_back({ 0, 0, width });
+	}
+
+	bool SkylinePacker::Fit(size_t index, uint32_t width, uint32_t height, uint32_t& outY) const
+	{
+		uint32_t x = m_Skyline[index].X;
+		if (x + width > m_Width)
+			return false;
+
+		// 矩形跨过的所有线段中最高的一段决定底边高度
+		uint32_t y = 0;
+		int64_t remaining = width;
+		for (size_t i = index; remaining > 0; i++)
+		{
+			y = std::max(y, m_Skyline[i].Y);
+			if (y + height > m_Height)
+				return false;
+
+			remaining -= m_Skyline[i].Width;
+		}
+
+		outY = y;
+		return true;
+	}
+
+	bool SkylinePacker::Pack(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY)
+	{
+		size_t bestIndex = m_Skyline.size();
+		uint32_t bestTop = UINT32_MAX, bestWidth = UINT32_MAX, bestY = 0;
+
+		for (size_t i = 0; i < m_Skyline.size(); i++)
+		{
+			uint32_t y;
+			if (!Fit(i, width, height, y))
+				continue;
+
+			// 顶边最低的位置优先，相同时选择更窄的线段，减少浪费
+			uint32_t top = y + height;
+			if (top < bestTop || (top == bestTop && m_Skyline[i].Width < bestWidth))
+			{
+				bestIndex = i;
+				bestTop = top;
+				bestWidth = m_Skyline[i].Width;
+				bestY = y;
+			}
+		}
+
+		if (bestIndex == m_Skyline.size())
+			return false;
+
+		outX = m_Skyline[bestIndex].X;
+		outY = bestY;
+
+		// 新线段覆盖矩形顶边，之后被它遮住的线段截短或移除
+		m_Skyline.insert(m_Skyline.begin() + bestIndex, { outX, bestTop, width });
+		for (size_t i = bestIndex + 1; i < m_Skyline.size();)
+		{
+			const Segment& previous = m_Skyline[i - 1];
+			Segment& segment = m_Skyline[i];
+
+			uint32_t previousEnd = previous.X + previous.Width;
+			if (segment.X >= previousEnd)
+				break;
+
+			uint32_t shrink = previousEnd - segment.X;
+			if (segment.Width <= shrink)
+			{
+				m_Skyline.erase(m_Skyline.begin() + i);
+				continue;
+			}
+
+			segment.X += shrink;
+			segment.Width -= shrink;
+			break;
+		}
+
+		// 合并高度相同的相邻线段
+		for (size_t i = 0; i + 1 < m_Skyline.size();)
+		{
+			if (m_Skyline[i].Y == m_Skyline[i + 1].Y)
+			{
+				m_Skyline[i].Width += m_Skyline[i + 1].Width;
+				m_Skyline.erase(m_Skyline.begin() + i + 1);
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		m_UsedArea += (uint64_t)width * height;
+		return true;
+	}
+
+	TextureAtlas::TextureAtlas(const TextureAtlasSpecification& specification)
+		: m_Specification(specification)
+	{
+	}
+
+	Ref<SubTexture2D> TextureAtlas::Add(const Ref<Texture2D>& texture)
+	{
+		auto it = m_Entries.find(texture.get());
+		if (it != m_Entries.end() && !it->second.Source.expired())
+			return it->second.SubTexture;
+
+		Ref<SubTexture2D> subTexture = Pack(texture);
+		m_Entries[texture.get()] = { texture, subTexture };
+		return subTexture;
+	}
+
+	Ref<SubTexture2D> TextureAtlas::Find(const Ref<Texture2D>& texture) const
+	{
+		auto it = m_Entries.find(texture.get());
+		if (it != m_Entries.end() && !it->second.Source.expired())
+			return it->second.SubTexture;
+		return nullptr;
+	}
+
+	void TextureAtlas::Clear()
+	{
+		m_Pages.clear();
+		m_Entries.clear();
+	}
+
+	Ref<SubTexture2D> TextureAtlas::Pack(const Ref<Texture2D>& texture)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		if (!texture->IsLoaded())
+			return nullptr;
+
+		const uint32_t width = texture->GetWidth();
+		const uint32_t height = texture->GetHeight();
+		if (width > m_Specification.MaxTextureSize || height > m_Specification.MaxTextureSize)
+			return nullptr;
+
+		const uint32_t padding = m_Specification.Padding;
+		const uint32_t paddedWidth = width + padding * 2;
+		const uint32_t paddedHeight = height + padding * 2;
+
+		// 优先放入透明度相同的已有图集页，都放不下时新建一页
+		const bool transparent = texture->HasTransparency();
+		Page* page = nullptr;
+		uint32_t x = 0, y = 0;
+		for (Page& candidate : m_Pages)
+		{
+			if (candidate.Transparent == transparent && candidate.Packer.Pack(paddedWidth, paddedHeight, x, y))
+			{
+				page = &candidate;
+				break;
+			}
+		}
+
+		if (!page)
+		{
+			if (m_Pages.size() >= m_Specification.MaxPages)
+			{
+				HZ_CORE_WARNING("Texture atlas is full ({0} pages)", m_Pages.size());
+				return nullptr;
+			}
+
+			Page& newPage = m_Pages.emplace_back(Page{ Texture2D::Create(m_Specification.PageSize, m_Specification.PageSize), SkylinePacker(m_Specification.PageSize, m_Specification.PageSize), transparent });
+			if (!newPage.Packer.Pack(paddedWidth, paddedHeight, x, y))
+				return nullptr;
+			page = &newPage;
+		}
+
+		// 读回源纹理，四周复制边缘像素后写入图集页
+		std::vector<uint32_t> pixels((size_t)width * height);
+		texture->GetData(pixels.data(), width * height * 4);
+
+		std::vector<uint32_t> padded((size_t)paddedWidth * paddedHeight);
+		for (uint32_t py = 0; py < paddedHeight; py++)
+		{
+			uint32_t sy = (uint32_t)std::clamp<int64_t>((int64_t)py - padding, 0, height - 1);
+			for (uint32_t px = 0; px < paddedWidth; px++)
+			{
+				uint32_t sx = (uint32_t)std::clamp<int64_t>((int64_t)px - padding, 0, width - 1);
+				padded[(size_t)py * paddedWidth + px] = pixels[(size_t)sy * width + sx];
+			}
+		}
+		page->Texture->SetData(padded.data(), x, y, paddedWidth, paddedHeight);
+
+		const float pageSize = (float)m_Specification.PageSize;
+		glm::vec2 min = { (float)(x + padding) / pageSize, (float)(y + padding) / pageSize };
+		glm::vec2 max = { (float)(x + padding + width) / pageSize, (float)(y + padding + height) / pageSize };
+		return CreateRef<SubTexture2D>(page->Texture, min, max);
+	}
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Hazel/Renderer/SubTexture2D.h"
+
+namespace Hazel {
+
+	/**
+	* Skyline 矩形装箱（Bottom-Left）
+	* 用一串水平线段记录已占用区域的上轮廓，新矩形放在使其顶边最低的位置
+	*/
+	class SkylinePacker
+	{
+	public:
+		SkylinePacker(uint32_t width, uint32_t height);
+
+		/** 放入 width * height 的矩形，返回左下角坐标，放不下时返回 false */
+		bool Pack(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY);
+
+		/** 已使用面积占比 */
+		float GetOccupancy() const { return (float)m_UsedArea / ((float)m_Width * (float)m_Height); }
+	private:
+		struct Segment
+		{
+			uint32_t X, Y, Width;
+		};
+
+		/** 以第 index 段为左端放入矩形时的底边高度，放不下时返回 false */
+		bool Fit(size_t index, uint32_t width, uint32_t height, uint32_t& outY) const;
+	private:
+		uint32_t m_Width, m_Height;
+		uint64_t m_UsedArea = 0;
+		std::vector<Segment> m_Skyline;
+	};
+
+	struct TextureAtlasSpecification
+	{
+		uint32_t PageSize = 2048;
+		/** 每张纹理四周复制边缘像素的宽度，避免线性过滤采样到相邻纹理 */
+		uint32_t Padding = 2;
+		/** 宽或高超过该值的纹理不打包 */
+		uint32_t MaxTextureSize = 256;
+		uint32_t MaxPages = 8;
+	};
+
+	/**
+	* 运行时纹理图集
+	* 把许多小纹理复制到共享的图集页中，绘制时使用图集页与 UV 矩形，
+	* 同一页上的纹理只占用一个纹理槽。
+	*/
+	class TextureAtlas
+	{
+	public:
+		TextureAtlas(const TextureAtlasSpecification& specification = TextureAtlasSpecification());
+
+		/**
+		* 返回 texture 在图集中的子纹理，第一次调用时把纹理读回并复制到图集页中
+		* 纹理过大或图集已满时返回空，只能在渲染线程调用
+		*/
+		Ref<SubTexture2D> Add(const Ref<Texture2D>& texture);
+
+		/** 只查找已经打包的纹理，不修改图集，可以在多个线程中同时调用 */
+		Ref<SubTexture2D> Find(const Ref<Texture2D>& texture) const;
+
+		void Clear();
+
+		uint32_t GetPageCount() const { return (uint32_t)m_Pages.size(); }
+		const Ref<Texture2D>& GetPage(uint32_t index) const { return m_Pages[index].Texture; }
+		float GetPageOccupancy(uint32_t index) const { return m_Pages[index].Packer.GetOccupancy(); }
+
+		const TextureAtlasSpecification& GetSpecification() const { return m_Specification; }
+	private:
+		Ref<SubTexture2D> Pack(const Ref<Texture2D>& texture);
+	private:
+		struct Page
+		{
+			Ref<Texture2D> Texture;
+			SkylinePacker Packer;
+			/** 半透明与不透明纹理打包到不同的页，避免一张半透明纹理让整页都按半透明绘制 */
+			bool Transparent;
+		};
+
+		struct Entry
+		{
+			/** 不持有源纹理，源纹理释放后地址可能被复用，需要重新打包 */
+			std::weak_ptr<Texture2D> Source;
+			Ref<SubTexture2D> SubTexture; // 为空表示该纹理不能打包
+		};
+
+		TextureAtlasSpecification m_Specification;
+		std::vector<Page> m_Pages;
+		std::unordered_map<const Texture2D*, Entry> m_Entries;
+	};
+
+}
@@ -7,6 +7,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "entt.hpp"
+
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
 
@@ -33,17 +35,29 @@ namespace Hazel {
 			: Tag(tag) {}
 	};
 
+	/**
+	* 修改 TransformComponent / SpriteRendererComponent 后需要通过 Entity::PatchComponent（registry.patch）通知场景，
+	* 场景据此只重新生成变化了的精灵实例与世界矩阵，直接通过引用修改不会被渲染缓存察觉
+	*/
 	struct TransformComponent
 	{
 		glm::vec3 Translation = { 0.0f, 0.0f, 0.0f };
 		glm::vec3 Rotation = { 0.0f, 0.0f, 0.0f };
 		glm::vec3 Scale = { 1.0f, 1.0f, 1.0f };
 
+		/**
+		* 缓存的世界矩阵，场景每帧在物理同步之后、绘制之前统一重新计算被 patch 过的变换
+		* 在此之前读取到的是上一次计算的结果；有父节点时 TRS 为相对父节点的局部变换
+		*/
+		glm::mat4 WorldTransform = glm::mat4(1.0f);
+		bool Dirty = true; // WorldTransform 已过期，实体在场景的待更新列表中
+
 		TransformComponent() = default;
 		TransformComponent(const TransformComponent&) = default;
 		TransformComponent(const glm::vec3& translation)
 			: Translation(translation) {}
 
+		/** 根据当前的 TRS 立即计算矩阵，不使用也不更新缓存 */
 		glm::mat4 GetTransform() const
 		{
 			glm::mat4 rotation = glm::toMat4(glm::quat(Rotation));
@@ -54,6 +68,29 @@ namespace Hazel {
 		}
 	};
 
+	/**
+	* 父子层级，由 Scene::SetParent 维护，不要直接修改
+	* 同一父节点的子节点组成双向链表；实体句柄只在所属场景内有效，序列化时通过 UUID 重新映射，
+	* Scene::Copy 与快照恢复原样保留实体编号，句柄直接复制
+	*/
+	struct RelationshipComponent
+	{
+		entt::entity Parent = entt::null;
+		entt::entity FirstChild = entt::null;
+		entt::entity PrevSibling = entt::null;
+		entt::entity NextSibling = entt::null;
+		/** 根节点为 0，场景按深度排序存储，传播时父节点总是先于子节点更新 */
+		uint32_t Depth = 0;
+
+		// 运行时数据
+		glm::mat4 LocalTransform = glm::mat4(1.0f); // 只有父节点移动时不需要重新计算局部矩阵
+		bool LocalDirty = false; // 本帧局部矩阵刚刚重新计算过，暂存在 TransformComponent::WorldTransform 中
+		bool WorldChanged = false; // 本帧世界矩阵发生了变化，子节点据此决定是否需要更新
+
+		RelationshipComponent() = default;
+		RelationshipComponent(const RelationshipComponent&) = default;
+	};
+
 	struct SpriteRendererComponent
 	{
 		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
@@ -76,6 +113,33 @@ namespace Hazel {
 		CircleRendererComponent(const CircleRendererComponent&) = default;
 	};
 
+	/**
+	* 视锥剔除用的包围盒代理，由 Scene 为 Circle 与不在保留缓存中的 Sprite 自动创建
+	* 运行时数据，不参与序列化与复制
+	*/
+	struct CullingProxyComponent
+	{
+		int32_t Proxy = -1; // DynamicAABBTree 中的代理，-1 表示还未插入
+		bool Dirty = false; // 世界矩阵变化后已经加入 Scene 的待更新列表，在下一次绘制前重新计算包围盒
+
+		CullingProxyComponent() = default;
+		CullingProxyComponent(const CullingProxyComponent&) = default;
+	};
+
+	/**
+	* 精灵在场景保留缓存（Renderer2D::RetainedBatch）中的槽位，由 Scene 在添加 Sprite 时自动创建
+	* 运行时数据，不参与序列化与复制
+	*/
+	struct RetainedSpriteComponent
+	{
+		uint32_t Slot = UINT32_MAX; // UINT32_MAX 表示还未分配
+		bool Dirty = true; // 变换或精灵数据变化后，在下一次绘制前重新生成实例
+		bool Retained = false; // 精灵半透明或缓存的纹理表已满时为 false，该精灵逐帧经过排序队列绘制
+
+		RetainedSpriteComponent() = default;
+		RetainedSpriteComponent(const RetainedSpriteComponent&) = default;
+	};
+
 	struct CameraComponent
 	{
 		SceneCamera Camera;
@@ -111,6 +175,13 @@ namespace Hazel {
 
 		// Storage for runtime
 		void* RuntimeBody = nullptr;
+		// 最近两个物理步结束时的状态，绘制时按累积的剩余时间在两者之间插值
+		glm::vec2 PreviousPosition = { 0.0f, 0.0f };
+		glm::vec2 CurrentPosition = { 0.0f, 0.0f };
+		float PreviousAngle = 0.0f;
+		float CurrentAngle = 0.0f;
+		/** 最后一步开始前刚体是否醒着，休眠的刚体不推进也不写回 */
+		bool Awake = true;
 
 		Rigidbody2DComponent() = default;
 		Rigidbody2DComponent(const Rigidbody2DComponent&) = default;
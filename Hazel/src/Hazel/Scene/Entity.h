@@ -39,6 +39,17 @@ namespace Hazel {
 			return m_Scene->m_Registry.get<T>(m_EntityHandle);
 		}
 
+		/**
+		* 通过回调修改组件并发出 on_update 信号，依赖脏标记的系统（如保留模式的精灵缓存）才能得知组件已改变
+		* 不传回调时只发出信号，用于已经通过引用修改过的组件
+		*/
+		template<typename T, typename... Func>
+		T& PatchComponent(Func&&... func)
+		{
+			HZ_CORE_ASSERT(HasComponent<T>(), "Entity does not have component!");
+			return m_Scene->m_Registry.patch<T>(m_EntityHandle, std::forward<Func>(func)...);
+		}
+
 		template<typename T>
 		bool HasComponent()
 		{
@@ -59,6 +70,11 @@ namespace Hazel {
 		UUID GetUUID() { return GetComponent<IDComponent>().ID; }
 		const std::string& GetName() { return GetComponent<TagComponent>().Tag; }
 
+		/** 见 Scene::SetParent */
+		void SetParent(Entity parent) { m_Scene->SetParent(*this, parent); }
+		Entity GetParent() { return m_Scene->GetParent(*this); }
+		uint32_t GetSiblingIndex() { return m_Scene->GetSiblingIndex(*this); }
+
 		bool operator==(const Entity& other) const
 		{
 			return m_EntityHandle == other.m_EntityHandle && m_Scene == other.m_Scene;
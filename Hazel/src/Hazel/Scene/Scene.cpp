@@ -3,7 +3,10 @@
 
 #include "Components.h"
 #include "ScriptableEntity.h"
+#include "TransformKernel.h"
+#include "Hazel/Core/JobSystem.h"
 #include "Hazel/Renderer/Renderer2D.h"
+#include "Hazel/Math/Math.h"
 
 #include <glm/glm.hpp>
 
@@ -31,26 +34,100 @@ namespace Hazel {
 		return b2_staticBody;
 	}
 
-	template<typename... Component>
-	static void CopyComponent(entt::registry& dst, entt::registry& src, const std::unordered_map<UUID, entt::entity>& enttMap)
+	// 世界矩阵按这么多个变换一块分到多个任务计算，保持 4 的倍数使每块都能完整使用 SIMD 分组
+	static constexpr uint32_t s_TransformChunkSize = 8192;
+
+	// 开启断言时每帧重新计算并比较这么多个世界矩阵，检查没有通过 patch 修改的变换
+	static constexpr size_t s_TransformValidationSamples = 64;
+
+	// 每个任务至少分到这么多精灵时才拆分成多个任务提交，数量较少时调度开销反而大于收益
+	static constexpr size_t s_ParallelSpriteThreshold = 4096;
+
+	/** 变换后单位 Quad（±0.5）的世界空间包围盒，Circle 同样绘制在单位 Quad 内 */
+	static AABB GetQuadBounds(const glm::mat4& transform)
 	{
-		([&]()
+		glm::vec3 center = transform[3];
+		glm::vec3 extents = 0.5f * (glm::abs(glm::vec3(transform[0])) + glm::abs(glm::vec3(transform[1])));
+		return { center - extents, center + extents };
+	}
+
+	static void DrawSprites(entt::registry& registry, const std::vector<uint32_t>& entities, std::vector<Renderer2D::ThreadBatch>& batches)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		// 视图在渲染线程上创建，工作线程只通过它读取组件；已经在保留缓存中绘制的精灵跳过
+		auto view = registry.view<TransformComponent, SpriteRendererComponent, RetainedSpriteComponent>();
+
+		const size_t spriteCount = entities.size();
+		const size_t jobCount = std::min<size_t>(JobSystem::GetWorkerCount() + 1, spriteCount / s_ParallelSpriteThreshold);
+		if (jobCount < 2)
 		{
-			auto view = src.view<Component>();
-			for (auto srcEntity : view)
+			for (uint32_t id : entities)
 			{
-				entt::entity dstEntity = enttMap.at(src.get<IDComponent>(srcEntity).ID);
+				entt::entity entity = (entt::entity)id;
+				if (!view.contains(entity) || view.get<RetainedSpriteComponent>(entity).Retained)
+					continue;
 
-				auto& srcComponent = src.get<Component>(srcEntity);
-				dst.emplace_or_replace<Component>(dstEntity, srcComponent);
+				auto [transform, sprite] = view.get<TransformComponent, SpriteRendererComponent>(entity);
+
+				Renderer2D::DrawSprite(transform.WorldTransform, sprite, (int)entity);
 			}
+			return;
+		}
+
+		// 每个任务填充一段连续的实体区间，批次的内存属于场景，跨帧复用以避免反复分配
+		if (batches.size() < jobCount)
+			batches.resize(jobCount);
+
+		const uint32_t chunkSize = (uint32_t)((spriteCount + jobCount - 1) / jobCount);
+
+		JobSystem::ParallelFor((uint32_t)spriteCount, chunkSize, [&view, &entities, &batches, chunkSize](uint32_t first, uint32_t last)
+		{
+			Renderer2D::ThreadBatch& batch = batches[first / chunkSize];
+
+			for (uint32_t i = first; i < last; i++)
+			{
+				entt::entity entity = (entt::entity)entities[i];
+				if (!view.contains(entity) || view.get<RetainedSpriteComponent>(entity).Retained)
+					continue;
+
+				auto [transform, sprite] = view.get<TransformComponent, SpriteRendererComponent>(entity);
+
+				batch.DrawSprite(transform.WorldTransform, sprite, (int)entity);
+			}
+		});
+
+		// 按区间顺序合并，保证绘制顺序与单线程提交一致；合并后立即清空，批次不会把纹理引用留到下一帧
+		for (size_t i = 0; i < jobCount; i++)
+		{
+			Renderer2D::Submit(batches[i]);
+			batches[i].Reset();
+		}
+	}
+
+	/**
+	* 按源存储的顺序整体复制组件，目标场景的实体编号与源场景相同，不需要映射
+	* 组件数组通过 vector 的区间插入复制，可平凡复制的组件（如 TransformComponent）直接按内存复制
+	*/
+	template<typename... Component>
+	static void CopyComponentStorage(entt::registry& dst, entt::registry& src)
+	{
+		([&]()
+		{
+			const size_t count = src.size<Component>();
+			if (count == 0)
+				return;
+
+			const entt::entity* entities = src.data<Component>();
+			const Component* components = src.raw<Component>();
+			dst.insert<Component>(entities, entities + count, components, components + count);
 		}(), ...);
 	}
 
 	template<typename... Component>
-	static void CopyComponent(ComponentGroup<Component...>, entt::registry& dst, entt::registry& src, const std::unordered_map<UUID, entt::entity>& enttMap)
+	static void CopyComponentStorage(ComponentGroup<Component...>, entt::registry& dst, entt::registry& src)
 	{
-		CopyComponent<Component...>(dst, src, enttMap);
+		CopyComponentStorage<Component...>(dst, src);
 	}
 
 	template<typename... Component>
@@ -69,8 +146,46 @@ namespace Hazel {
 		CopyComponentIfExists<Component...>(dst, src);
 	}
 
+	template<typename... Component>
+	static void PrepareComponentPools(entt::registry& registry)
+	{
+		(registry.prepare<Component>(), ...);
+	}
+
+	template<typename... Component>
+	static void PrepareComponentPools(ComponentGroup<Component...>, entt::registry& registry)
+	{
+		PrepareComponentPools<Component...>(registry);
+	}
+
+	/** 相机系统写入、绘制系统读取的资源，不对应任何组件 */
+	struct RuntimeCameraResource {};
+
 	Scene::Scene()
 	{
+		// 组件存储在第一次访问时创建，提前创建好，并行执行的系统只访问已有的存储
+		PrepareComponentPools(AllComponents{}, m_Registry);
+		PrepareComponentPools<IDComponent, TagComponent, RelationshipComponent, CullingProxyComponent, RetainedSpriteComponent>(m_Registry);
+
+		// 世界矩阵只在变换被 patch 之后重新计算，复制场景时的 emplace_or_replace 同样会触发
+		m_Registry.on_construct<TransformComponent>().connect<&Scene::OnTransformChanged>(this);
+		m_Registry.on_update<TransformComponent>().connect<&Scene::OnTransformChanged>(this);
+
+		// Circle 与不在保留缓存中的精灵同步到视锥剔除的 AABB 树，Scene::Copy 直接操作 registry，也会触发这些回调；
+		// 精灵的包围盒在 UpdateRetainedSprites 中按是否进入保留缓存添加或移除
+		m_Registry.on_construct<CircleRendererComponent>().connect<&Scene::OnCircleConstruct>(this);
+		m_Registry.on_destroy<CircleRendererComponent>().connect<&Scene::OnCircleDestroy>(this);
+		m_Registry.on_construct<CullingProxyComponent>().connect<&Scene::OnCullingProxyConstruct>(this);
+		m_Registry.on_destroy<CullingProxyComponent>().connect<&Scene::OnCullingProxyDestroy>(this);
+
+		// 精灵实例保留在 GPU 缓冲中，只有变换或精灵数据被 patch 过的实体才重新生成
+		m_Registry.on_construct<SpriteRendererComponent>().connect<&Scene::OnSpriteConstruct>(this);
+		m_Registry.on_destroy<SpriteRendererComponent>().connect<&Scene::OnSpriteDestroy>(this);
+		m_Registry.on_update<SpriteRendererComponent>().connect<&Scene::OnSpriteUpdate>(this);
+		m_Registry.on_update<TransformComponent>().connect<&Scene::OnSpriteUpdate>(this);
+		m_Registry.on_destroy<RetainedSpriteComponent>().connect<&Scene::OnRetainedSpriteDestroy>(this);
+
+		RegisterRuntimeSystems();
 	}
 
 	Scene::~Scene()
@@ -84,23 +199,24 @@ namespace Hazel {
 
 		newScene->m_ViewportWidth = other->m_ViewportWidth;
 		newScene->m_ViewportHeight = other->m_ViewportHeight;
+		newScene->m_PhysicsSettings = other->m_PhysicsSettings;
 
 		auto& srcSceneRegistry = other->m_Registry;
 		auto& dstSceneRegistry = newScene->m_Registry;
-		std::unordered_map<UUID, entt::entity> enttMap;
 
-		// Create entities in new scene
-		auto idView = srcSceneRegistry.view<IDComponent>();
-		for (auto e : idView)
-		{
-			UUID uuid = srcSceneRegistry.get<IDComponent>(e).ID;
-			const auto& name = srcSceneRegistry.get<TagComponent>(e).Tag;
-			Entity newEntity = newScene->CreateEntityWithUUID(uuid, name);
-			enttMap[uuid] = (entt::entity)newEntity;
-		}
+		// 实体列表（包括已销毁、等待复用的编号）原样复制，之后各组件存储按实体编号整体插入
+		dstSceneRegistry.assign(srcSceneRegistry.data(), srcSceneRegistry.data() + srcSceneRegistry.size());
 
-		// Copy components (except IDComponent and TagComponent)
-		CopyComponent(AllComponents{}, dstSceneRegistry, srcSceneRegistry, enttMap);
+		// 每个新变换都会触发一次 on_construct，提前分配脏列表
+		newScene->m_DirtyTransforms.reserve(srcSceneRegistry.size<TransformComponent>());
+
+		// 剔除代理与保留精灵由组件的 on_construct 回调在新场景中重新创建
+		CopyComponentStorage<IDComponent, TagComponent, RelationshipComponent>(dstSceneRegistry, srcSceneRegistry);
+		CopyComponentStorage(AllComponents{}, dstSceneRegistry, srcSceneRegistry);
+
+		// 实体编号不变，层级中的句柄与 UUID 索引都无需重新映射；存储顺序也与源场景一致
+		newScene->m_HierarchyOrderDirty = other->m_HierarchyOrderDirty;
+		newScene->m_EntityIndex = other->m_EntityIndex;
 
 		return newScene;
 	}
@@ -114,6 +230,8 @@ namespace Hazel {
 	{
 		Entity entity = { m_Registry.create(), this };
 		entity.AddComponent<IDComponent>(uuid);
+		if (!m_EntityIndex.Insert(uuid, entity))
+			HZ_CORE_WARNING("Duplicate entity UUID {0}, lookups will return the newest entity", (uint64_t)uuid);
 		entity.AddComponent<TransformComponent>();
 		auto& tag = entity.AddComponent<TagComponent>();
 		tag.Tag = name.empty() ? "Entity" : name;
@@ -122,9 +240,44 @@ namespace Hazel {
 
 	void Scene::DestroyEntity(Entity entity)
 	{
+		// 子节点随父节点一起销毁
+		if (m_Registry.has<RelationshipComponent>(entity))
+		{
+			DetachFromParent(entity);
+
+			std::vector<entt::entity> subtree;
+			CollectSubtree(entity, subtree);
+			for (entt::entity e : subtree)
+			{
+				EraseFromEntityIndex(e);
+				m_Registry.destroy(e);
+			}
+
+			m_HierarchyOrderDirty = true;
+			return;
+		}
+
+		EraseFromEntityIndex(entity);
 		m_Registry.destroy(entity);
 	}
 
+	void Scene::EraseFromEntityIndex(entt::entity entity)
+	{
+		// UUID 重复时索引指向最新创建的实体，销毁较早的那个不能把它移除
+		UUID uuid = m_Registry.get<IDComponent>(entity).ID;
+		if (m_EntityIndex.Find(uuid) == entity)
+			m_EntityIndex.Erase(uuid);
+	}
+
+	Entity Scene::GetEntityByUUID(UUID uuid)
+	{
+		entt::entity entity = m_EntityIndex.Find(uuid);
+		if (entity == entt::null)
+			return {};
+
+		return { entity, this };
+	}
+
 	void Scene::OnRuntimeStart()
 	{
 		OnPhysics2DStart();
@@ -147,7 +300,13 @@ namespace Hazel {
 
 	void Scene::OnUpdateRuntime(Timestep ts)
 	{
-		// Update scripts
+		m_RuntimeSystems.Run(ts);
+	}
+
+	void Scene::RegisterRuntimeSystems()
+	{
+		// 脚本可以访问任意组件，也可能读取输入，单独在主线程上执行
+		m_RuntimeSystems.AddSystem("Scripts", [this](Timestep ts)
 		{
 			m_Registry.view<NativeScriptComponent>().each([=](auto entity, auto& nsc)
 			{
@@ -161,39 +320,31 @@ namespace Hazel {
 
 				nsc.Instance->OnUpdate(ts);
 			});
-		}
+		}).Exclusive().MainThread();
 
 		// Physics 物理更新
+		// 推进物理时同时记录刚体的插值状态
+		m_RuntimeSystems.AddSystem("Physics Step", [this](Timestep ts)
 		{
-			const int32_t velocityIterations = 6;
-			const int32_t positionIterations = 2;
-			m_PhysicsWorld->Step(ts, velocityIterations, positionIterations);
+			StepPhysics(ts);
+		}).Writes<b2World, Rigidbody2DComponent>();
 
-			// Retrieve transform from Box2D
-			auto view = m_Registry.view<Rigidbody2DComponent>();
-			for (auto e : view)
-			{
-				Entity entity = { e, this };
-				auto& transform = entity.GetComponent<TransformComponent>();
-				auto& rb2d = entity.GetComponent<Rigidbody2DComponent>();
-
-				// 获取刚体及其物理模拟得数据
-				b2Body* body = (b2Body*)rb2d.RuntimeBody;
-				const auto& position = body->GetPosition();
-
-				// 将物理模拟位置旋转信息设置回模型上
-				transform.Translation.x = position.x;
-				transform.Translation.y = position.y;
-				transform.Rotation.z = body->GetAngle();
-			}
-		}
+		// patch 会触发变换与保留精灵的脏标记回调，因此同样声明写入 RetainedSpriteComponent
+		m_RuntimeSystems.AddSystem("Physics Writeback", [this](Timestep ts)
+		{
+			WritebackPhysics();
+		}).Reads<b2World, Rigidbody2DComponent>().Writes<TransformComponent, RetainedSpriteComponent>();
 
-		// Render 2D
-		Camera* mainCamera = nullptr;
-		glm::mat4 cameraTransform;
+		m_RuntimeSystems.AddSystem("World Transforms", [this](Timestep ts)
+		{
+			UpdateWorldTransforms();
+		}).Writes<TransformComponent, RelationshipComponent, RetainedSpriteComponent, CullingProxyComponent>();
 
+		// 获取场景中的相机，启动后得视角将以这个相机为主
+		m_RuntimeSystems.AddSystem("Camera", [this](Timestep ts)
 		{
-			// 获取场景中的相机，启动后得视角将以这个相机为主
+			m_RuntimeCamera = nullptr;
+
 			auto view = m_Registry.view<TransformComponent, CameraComponent>();
 			for (auto entity : view)
 			{
@@ -201,67 +352,35 @@ namespace Hazel {
 
 				if (camera.Primary)
 				{
-					mainCamera = &camera.Camera;
-					cameraTransform = transform.GetTransform();
+					m_RuntimeCamera = &camera.Camera;
+					m_RuntimeCameraTransform = transform.WorldTransform;
 					break;
 				}
 			}
-		}
+		}).Reads<TransformComponent, CameraComponent>().Writes<RuntimeCameraResource>();
 
-		// 场景中存在主相机时
-		if (mainCamera)
+		// Render 2D，OpenGL 调用只能在主线程上执行
+		m_RuntimeSystems.AddSystem("Render", [this](Timestep ts)
 		{
-			Renderer2D::BeginScene(*mainCamera, cameraTransform);
-
-			// Draw sprites
-			{
-				auto group = m_Registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
-				for (auto entity : group)
-				{
-					auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
-
-					Renderer2D::DrawSprite(transform.GetTransform(), sprite, (int)entity);
-				}
-			}
+			// 场景中存在主相机时
+			if (!m_RuntimeCamera)
+				return;
 
-			// Draw circles
-			{
-				auto view = m_Registry.view<TransformComponent, CircleRendererComponent>();
-				for (auto entity : view)
-				{
-					auto [transform, circle] = view.get<TransformComponent, CircleRendererComponent>(entity);
+			Renderer2D::BeginScene(*m_RuntimeCamera, m_RuntimeCameraTransform);
 
-					Renderer2D::DrawCircle(transform.GetTransform(), circle.Color, circle.Thickness, circle.Fade, (int)entity);
-				}
-			}
+			DrawRenderables(m_RuntimeCamera->GetProjection() * glm::inverse(m_RuntimeCameraTransform));
 
 			Renderer2D::EndScene();
-		}
+		}).Reads<RuntimeCameraResource, TransformComponent, SpriteRendererComponent, CircleRendererComponent>()
+			.Writes<CullingProxyComponent, RetainedSpriteComponent>()
+			.MainThread();
 	}
 
 	void Scene::OnUpdateSimulation(Timestep ts, EditorCamera& camera)
 	{
 		// Physics
-		{
-			const int32_t velocityIterations = 6;
-			const int32_t positionIterations = 2;
-			m_PhysicsWorld->Step(ts, velocityIterations, positionIterations);
-
-			// Retrieve transform from Box2D
-			auto view = m_Registry.view<Rigidbody2DComponent>();
-			for (auto e : view)
-			{
-				Entity entity = { e, this };
-				auto& transform = entity.GetComponent<TransformComponent>();
-				auto& rb2d = entity.GetComponent<Rigidbody2DComponent>();
-
-				b2Body* body = (b2Body*)rb2d.RuntimeBody;
-				const auto& position = body->GetPosition();
-				transform.Translation.x = position.x;
-				transform.Translation.y = position.y;
-				transform.Rotation.z = body->GetAngle();
-			}
-		}
+		StepPhysics(ts);
+		WritebackPhysics();
 
 		// Render
 		RenderScene(camera);
@@ -290,9 +409,155 @@ namespace Hazel {
 	}
 
 	void Scene::DuplicateEntity(Entity entity)
+	{
+		DuplicateSubtree(entity, GetParent(entity));
+	}
+
+	Entity Scene::DuplicateSubtree(Entity entity, Entity parent)
 	{
 		Entity newEntity = CreateEntity(entity.GetName());
 		CopyComponentIfExists(AllComponents{}, newEntity, entity);
+		if (parent)
+			SetParent(newEntity, parent);
+
+		auto* relationship = m_Registry.try_get<RelationshipComponent>(entity);
+		if (!relationship)
+			return newEntity;
+
+		// 复制过程中组件存储会扩容，先记下子节点；子节点插入在链表头部，逆序复制才能保持兄弟顺序
+		std::vector<entt::entity> children;
+		for (entt::entity child = relationship->FirstChild; child != entt::null; child = m_Registry.get<RelationshipComponent>(child).NextSibling)
+			children.push_back(child);
+
+		for (auto it = children.rbegin(); it != children.rend(); ++it)
+			DuplicateSubtree({ *it, this }, newEntity);
+
+		return newEntity;
+	}
+
+	void Scene::SetParent(Entity child, Entity parent)
+	{
+		HZ_CORE_ASSERT(child, "Invalid entity!");
+
+		entt::entity childHandle = child;
+		entt::entity parentHandle = parent;
+
+		// 不能挂到自身或后代下面，否则会形成环
+		for (entt::entity ancestor = parentHandle; ancestor != entt::null;)
+		{
+			if (ancestor == childHandle)
+			{
+				HZ_CORE_WARNING("Cannot parent entity '{0}' to itself or one of its descendants", child.GetName());
+				return;
+			}
+
+			auto* relationship = m_Registry.try_get<RelationshipComponent>(ancestor);
+			if (!relationship)
+				break;
+			ancestor = relationship->Parent;
+		}
+
+		// 先添加组件再取引用，添加时存储扩容会使之前的引用失效
+		GetOrAddRelationship(childHandle);
+		if (parentHandle != entt::null)
+			GetOrAddRelationship(parentHandle);
+
+		auto& relationship = m_Registry.get<RelationshipComponent>(childHandle);
+		if (relationship.Parent == parentHandle)
+			return;
+
+		DetachFromParent(childHandle);
+
+		if (parentHandle != entt::null)
+		{
+			// 插入到父节点子链表的头部
+			auto& parentRelationship = m_Registry.get<RelationshipComponent>(parentHandle);
+			relationship.Parent = parentHandle;
+			relationship.NextSibling = parentRelationship.FirstChild;
+			if (parentRelationship.FirstChild != entt::null)
+				m_Registry.get<RelationshipComponent>(parentRelationship.FirstChild).PrevSibling = childHandle;
+			parentRelationship.FirstChild = childHandle;
+		}
+
+		// 整个子树的深度随之改变，父节点总是先于子节点更新
+		std::vector<entt::entity> subtree;
+		CollectSubtree(childHandle, subtree);
+		for (entt::entity e : subtree)
+		{
+			auto& node = m_Registry.get<RelationshipComponent>(e);
+			node.Depth = node.Parent == entt::null ? 0 : m_Registry.get<RelationshipComponent>(node.Parent).Depth + 1;
+		}
+		m_HierarchyOrderDirty = true;
+
+		// TRS 不变，世界矩阵需要按新的父节点重新计算
+		m_Registry.patch<TransformComponent>(childHandle);
+	}
+
+	Entity Scene::GetParent(Entity entity)
+	{
+		auto* relationship = m_Registry.try_get<RelationshipComponent>(entity);
+		if (!relationship || relationship->Parent == entt::null)
+			return {};
+
+		return { relationship->Parent, this };
+	}
+
+	uint32_t Scene::GetSiblingIndex(Entity entity)
+	{
+		auto* relationship = m_Registry.try_get<RelationshipComponent>(entity);
+		if (!relationship)
+			return 0;
+
+		uint32_t index = 0;
+		for (entt::entity sibling = relationship->PrevSibling; sibling != entt::null; sibling = m_Registry.get<RelationshipComponent>(sibling).PrevSibling)
+			index++;
+		return index;
+	}
+
+	RelationshipComponent& Scene::GetOrAddRelationship(entt::entity entity)
+	{
+		if (auto* relationship = m_Registry.try_get<RelationshipComponent>(entity))
+			return *relationship;
+
+		// 加入层级之前 LocalTransform 没有计算过
+		m_Registry.patch<TransformComponent>(entity);
+		m_HierarchyOrderDirty = true;
+		return m_Registry.emplace<RelationshipComponent>(entity);
+	}
+
+	void Scene::DetachFromParent(entt::entity entity)
+	{
+		auto& relationship = m_Registry.get<RelationshipComponent>(entity);
+		if (relationship.Parent == entt::null)
+			return;
+
+		if (relationship.PrevSibling != entt::null)
+			m_Registry.get<RelationshipComponent>(relationship.PrevSibling).NextSibling = relationship.NextSibling;
+		else
+			m_Registry.get<RelationshipComponent>(relationship.Parent).FirstChild = relationship.NextSibling;
+
+		if (relationship.NextSibling != entt::null)
+			m_Registry.get<RelationshipComponent>(relationship.NextSibling).PrevSibling = relationship.PrevSibling;
+
+		relationship.Parent = entt::null;
+		relationship.PrevSibling = entt::null;
+		relationship.NextSibling = entt::null;
+	}
+
+	void Scene::CollectSubtree(entt::entity entity, std::vector<entt::entity>& outEntities)
+	{
+		// 广度优先，不递归，很深的层级也不会栈溢出
+		size_t first = outEntities.size();
+		outEntities.push_back(entity);
+		for (size_t i = first; i < outEntities.size(); i++)
+		{
+			auto* relationship = m_Registry.try_get<RelationshipComponent>(outEntities[i]);
+			if (!relationship)
+				continue;
+
+			for (entt::entity child = relationship->FirstChild; child != entt::null; child = m_Registry.get<RelationshipComponent>(child).NextSibling)
+				outEntities.push_back(child);
+		}
 	}
 
 	Entity Scene::GetPrimaryCameraEntity()
@@ -312,32 +577,48 @@ namespace Hazel {
 		// 构造物理世界上下文
 		// -9.8f 表示重力加速度的 Y 方向分量，其来源是地球表面的标准重力加速度。
 		m_PhysicsWorld = new b2World({ 0.0f, -9.8f });
+		m_PhysicsAccumulator = 0.0f;
+		m_MovableBodies.clear();
+		m_MovingBodies.clear();
+
+		// 刚体在世界空间中创建，复制出的场景中世界矩阵还没有计算
+		UpdateWorldTransforms();
 
 		auto view = m_Registry.view<Rigidbody2DComponent>();
 		for (auto e : view)
 		{
 			Entity entity = { e, this };
-			auto& transform = entity.GetComponent<TransformComponent>();
 			auto& rb2d = entity.GetComponent<Rigidbody2DComponent>();
 
+			// 子节点的 TRS 是相对父节点的，从世界矩阵中分解出刚体的位置、角度与碰撞体的缩放
+			glm::vec3 translation, rotation, scale;
+			Math::DecomposeTransform(entity.GetComponent<TransformComponent>().WorldTransform, translation, rotation, scale);
+
 			// 刚体初始参数定义
 			b2BodyDef bodyDef;
 			bodyDef.type = Rigidbody2DTypeToBox2DBody(rb2d.Type); // 刚体类型 静态/动态
-			bodyDef.position.Set(transform.Translation.x, transform.Translation.y); // 刚体位置信息
-			bodyDef.angle = transform.Rotation.z; // 刚体旋转信息
+			bodyDef.position.Set(translation.x, translation.y); // 刚体位置信息
+			bodyDef.angle = rotation.z; // 刚体旋转信息
+			bodyDef.userData.pointer = (uintptr_t)e; // 写回时从刚体找到实体
 
 			// 构建刚体
 			b2Body* body = m_PhysicsWorld->CreateBody(&bodyDef);
 			body->SetFixedRotation(rb2d.FixedRotation);
 			rb2d.RuntimeBody = body;
 
+			rb2d.PreviousPosition = rb2d.CurrentPosition = { translation.x, translation.y };
+			rb2d.PreviousAngle = rb2d.CurrentAngle = rotation.z;
+			rb2d.Awake = true;
+			if (rb2d.Type != Rigidbody2DComponent::BodyType::Static)
+				m_MovableBodies.push_back(body);
+
 			if (entity.HasComponent<BoxCollider2DComponent>())
 			{
 				auto& bc2d = entity.GetComponent<BoxCollider2DComponent>();
 
 				// 刚体得大小
 				b2PolygonShape boxShape;
-				boxShape.SetAsBox(bc2d.Size.x * transform.Scale.x, bc2d.Size.y * transform.Scale.y);
+				boxShape.SetAsBox(bc2d.Size.x * scale.x, bc2d.Size.y * scale.y);
 
 				// 刚体样式
 				b2FixtureDef fixtureDef;
@@ -355,7 +636,7 @@ namespace Hazel {
 
 				b2CircleShape circleShape;
 				circleShape.m_p.Set(cc2d.Offset.x, cc2d.Offset.y);
-				circleShape.m_radius = transform.Scale.x * cc2d.Radius;
+				circleShape.m_radius = scale.x * cc2d.Radius;
 
 				b2FixtureDef fixtureDef;
 				fixtureDef.shape = &circleShape;
@@ -370,37 +651,434 @@ namespace Hazel {
 
 	void Scene::OnPhysics2DStop()
 	{
+		m_MovableBodies.clear();
+		m_MovingBodies.clear();
+
 		delete m_PhysicsWorld;
 		m_PhysicsWorld = nullptr;
 	}
 
-	void Scene::RenderScene(EditorCamera& camera)
+	void Scene::StepPhysics(Timestep ts)
 	{
-		Renderer2D::BeginScene(camera);
+		HZ_PROFILE_FUNCTION();
 
-		// Draw sprites
+		const float fixedTimestep = m_PhysicsSettings.FixedTimestep;
+		const uint32_t maxSubsteps = std::max(m_PhysicsSettings.MaxSubsteps, 1u);
+
+		m_PhysicsAccumulator += ts;
+		uint32_t stepCount = (uint32_t)(m_PhysicsAccumulator / fixedTimestep);
+		if (stepCount > maxSubsteps)
+		{
+			// 物理跟不上时放慢模拟，而不是让下一帧需要更多的步数
+			m_PhysicsAccumulator = std::fmod(m_PhysicsAccumulator, fixedTimestep) + maxSubsteps * fixedTimestep;
+			stepCount = maxSubsteps;
+		}
+
+		if (stepCount == 0)
+			return;
+
+		for (uint32_t step = 0; step < stepCount; step++)
+		{
+			// 插值只需要最后两步的状态
+			if (step == stepCount - 1)
+			{
+				for (b2Body* body : m_MovableBodies)
+				{
+					auto& rb2d = m_Registry.get<Rigidbody2DComponent>((entt::entity)body->GetUserData().pointer);
+					rb2d.Awake = body->IsAwake();
+					if (rb2d.Awake)
+					{
+						rb2d.PreviousPosition = { body->GetPosition().x, body->GetPosition().y };
+						rb2d.PreviousAngle = body->GetAngle();
+					}
+				}
+			}
+
+			m_PhysicsWorld->Step(fixedTimestep, m_PhysicsSettings.VelocityIterations, m_PhysicsSettings.PositionIterations);
+			m_PhysicsAccumulator -= fixedTimestep;
+		}
+
+		// 一直在休眠的刚体没有移动，之后的写回跳过它们
+		m_MovingBodies.clear();
+		for (b2Body* body : m_MovableBodies)
 		{
-			auto group = m_Registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
-			for (auto entity : group)
+			auto& rb2d = m_Registry.get<Rigidbody2DComponent>((entt::entity)body->GetUserData().pointer);
+			const bool awake = body->IsAwake();
+			if (!rb2d.Awake && !awake)
+				continue;
+
+			// 在最后一步中被唤醒，从上次显示的静止状态开始插值
+			if (!rb2d.Awake)
 			{
-				auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
+				rb2d.PreviousPosition = rb2d.CurrentPosition;
+				rb2d.PreviousAngle = rb2d.CurrentAngle;
+			}
+
+			rb2d.CurrentPosition = { body->GetPosition().x, body->GetPosition().y };
+			rb2d.CurrentAngle = body->GetAngle();
 
-				Renderer2D::DrawSprite(transform.GetTransform(), sprite, (int)entity);
+			// 在最后一步中进入休眠，直接停在最终位置，之后不再写回
+			if (!awake)
+			{
+				rb2d.PreviousPosition = rb2d.CurrentPosition;
+				rb2d.PreviousAngle = rb2d.CurrentAngle;
 			}
+
+			m_MovingBodies.push_back(body);
 		}
+	}
+
+	void Scene::WritebackPhysics()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		// 剩余时间占一个步长的比例，绘制的状态比物理滞后不到一步
+		const float alpha = m_PhysicsSettings.Interpolate ? std::clamp(m_PhysicsAccumulator / m_PhysicsSettings.FixedTimestep, 0.0f, 1.0f) : 1.0f;
+
+		for (b2Body* body : m_MovingBodies)
+		{
+			entt::entity entity = (entt::entity)body->GetUserData().pointer;
+			auto [rb2d, transform] = m_Registry.get<Rigidbody2DComponent, TransformComponent>(entity);
+
+			glm::vec2 position = glm::mix(rb2d.PreviousPosition, rb2d.CurrentPosition, alpha);
+			float angle = glm::mix(rb2d.PreviousAngle, rb2d.CurrentAngle, alpha);
+
+			// 刚体的状态在世界空间中，子节点换算到父节点空间后写入 TRS；
+			// 父节点的世界矩阵是上一次更新的结果，父节点本身也由物理驱动时子节点会滞后一帧
+			auto* relationship = m_Registry.try_get<RelationshipComponent>(entity);
+			if (relationship && relationship->Parent != entt::null)
+			{
+				const glm::mat4& parentTransform = m_Registry.get<TransformComponent>(relationship->Parent).WorldTransform;
+				glm::mat4 world = glm::translate(glm::mat4(1.0f), glm::vec3(position, transform.WorldTransform[3].z))
+					* glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 0.0f, 1.0f));
+
+				glm::vec3 translation, rotation, scale;
+				Math::DecomposeTransform(glm::inverse(parentTransform) * world, translation, rotation, scale);
+				position = { translation.x, translation.y };
+				angle = rotation.z;
+			}
+
+			// 没有移动时不 patch，避免重新计算世界矩阵与精灵实例
+			if (transform.Translation.x == position.x && transform.Translation.y == position.y && transform.Rotation.z == angle)
+				continue;
+
+			transform.Translation.x = position.x;
+			transform.Translation.y = position.y;
+			transform.Rotation.z = angle;
+			m_Registry.patch<TransformComponent>(entity);
+		}
+	}
+
+	void Scene::RenderScene(EditorCamera& camera)
+	{
+		UpdateWorldTransforms();
+
+		Renderer2D::BeginScene(camera);
+
+		DrawRenderables(camera.GetViewProjection());
+
+		Renderer2D::EndScene();
+	}
+
+	void Scene::DrawRenderables(const glm::mat4& viewProjection)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		// 保留缓存中的不透明精灵不参与剔除，由 GPU 裁剪视口外的部分，在不透明通道中绘制
+		UpdateRetainedSprites();
+		Renderer2D::DrawRetained(m_RetainedSprites);
+
+		UpdateCullingProxies();
+
+		m_VisibleEntities.clear();
+		m_CullingTree.Query(Frustum(viewProjection), m_VisibleEntities);
+
+		// 树的遍历顺序与实体无关，按实体编号排序使每帧的提交顺序保持稳定
+		std::sort(m_VisibleEntities.begin(), m_VisibleEntities.end());
+
+		uint32_t drawnCount = (uint32_t)m_VisibleEntities.size();
+		Renderer2D::AddCullingStats(drawnCount, m_CullingTree.GetProxyCount() - drawnCount);
+
+		// Draw sprites
+		DrawSprites(m_Registry, m_VisibleEntities, m_SpriteBatches);
 
 		// Draw circles
 		{
 			auto view = m_Registry.view<TransformComponent, CircleRendererComponent>();
-			for (auto entity : view)
+			for (uint32_t id : m_VisibleEntities)
 			{
+				entt::entity entity = (entt::entity)id;
+				if (!view.contains(entity))
+					continue;
+
 				auto [transform, circle] = view.get<TransformComponent, CircleRendererComponent>(entity);
 
-				Renderer2D::DrawCircle(transform.GetTransform(), circle.Color, circle.Thickness, circle.Fade, (int)entity);
+				Renderer2D::DrawCircle(transform.WorldTransform, circle.Color, circle.Thickness, circle.Fade, (int)entity);
 			}
 		}
+	}
 
-		Renderer2D::EndScene();
+	void Scene::UpdateCullingProxies()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		// 只有新插入的包围盒与世界矩阵变化过的实体（包括随父节点移动的子节点）在列表中，
+		// 包围盒仍在放大范围内时 MoveProxy 不会修改树
+		for (entt::entity entity : m_DirtyCullingProxies)
+		{
+			// 标记之后实体或包围盒可能已经被销毁
+			if (!m_Registry.valid(entity))
+				continue;
+
+			auto* proxy = m_Registry.try_get<CullingProxyComponent>(entity);
+			if (!proxy || !proxy->Dirty)
+				continue;
+
+			proxy->Dirty = false;
+
+			AABB bounds = GetQuadBounds(m_Registry.get<TransformComponent>(entity).WorldTransform);
+			if (proxy->Proxy != DynamicAABBTree::NullNode)
+				m_CullingTree.MoveProxy(proxy->Proxy, bounds);
+			else
+				proxy->Proxy = m_CullingTree.CreateProxy(bounds, (uint32_t)entity);
+		}
+		m_DirtyCullingProxies.clear();
+	}
+
+	void Scene::MarkCullingProxyDirty(entt::entity entity)
+	{
+		auto* proxy = m_Registry.try_get<CullingProxyComponent>(entity);
+		if (!proxy || proxy->Dirty)
+			return;
+
+		proxy->Dirty = true;
+		m_DirtyCullingProxies.push_back(entity);
+	}
+
+	void Scene::UpdateWorldTransforms()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		if (m_HierarchyOrderDirty)
+		{
+			// 子节点的深度总是大于父节点，按深度排序后顺序遍历即可自上而下传播；变换存储按同样的顺序排列，传播时连续访问
+			m_Registry.sort<RelationshipComponent>([](const auto& lhs, const auto& rhs) { return lhs.Depth < rhs.Depth; });
+			m_Registry.sort<TransformComponent, RelationshipComponent>();
+			m_HierarchyOrderDirty = false;
+		}
+
+		m_TransformUpdateBuffer.clear();
+		for (entt::entity entity : m_DirtyTransforms)
+		{
+			// 标记之后实体可能已经被销毁，同一个实体也可能被标记多次
+			if (!m_Registry.valid(entity))
+				continue;
+
+			auto* transform = m_Registry.try_get<TransformComponent>(entity);
+			if (!transform || !transform->Dirty)
+				continue;
+
+			transform->Dirty = false;
+			m_TransformUpdateBuffer.push_back(transform);
+			MarkCullingProxyDirty(entity);
+
+			if (auto* relationship = m_Registry.try_get<RelationshipComponent>(entity))
+			{
+				relationship->LocalDirty = true;
+				m_HierarchyTransformsDirty = true;
+			}
+		}
+		m_DirtyTransforms.clear();
+
+		// 各个变换互不依赖，分块在多个线程上计算
+		JobSystem::ParallelFor((uint32_t)m_TransformUpdateBuffer.size(), s_TransformChunkSize, [this](uint32_t first, uint32_t last)
+		{
+			TransformKernel::UpdateWorldTransforms(m_TransformUpdateBuffer.data() + first, last - first);
+		});
+
+		// 没有层级中的变换被修改时，所有子节点的世界矩阵都不变
+		if (m_HierarchyTransformsDirty)
+		{
+			PropagateHierarchyTransforms();
+			m_HierarchyTransformsDirty = false;
+		}
+
+#ifdef HZ_ENABLE_ASSERTS
+		ValidateWorldTransforms();
+#endif
+	}
+
+#ifdef HZ_ENABLE_ASSERTS
+	void Scene::ValidateWorldTransforms()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		auto view = m_Registry.view<TransformComponent>();
+		size_t count = view.size();
+		if (count == 0)
+			return;
+
+		// 每帧只检查固定数量的实体，游标在存储中循环，所有实体都会依次被检查到
+		const entt::entity* entities = view.data();
+		size_t sampleCount = std::min(count, s_TransformValidationSamples);
+		for (size_t i = 0; i < sampleCount; i++)
+		{
+			m_TransformValidationCursor = (m_TransformValidationCursor + 1) % count;
+			entt::entity entity = entities[m_TransformValidationCursor];
+
+			const auto& transform = view.get<TransformComponent>(entity);
+			if (transform.Dirty)
+				continue;
+
+			glm::mat4 expected = transform.GetTransform();
+			auto* relationship = m_Registry.try_get<RelationshipComponent>(entity);
+			if (relationship && relationship->Parent != entt::null)
+				expected = m_Registry.get<TransformComponent>(relationship->Parent).WorldTransform * expected;
+
+			// 变换内核与 glm 的运算顺序不同，按矩阵元素的大小留出误差
+			bool matches = true;
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 4; row++)
+				{
+					float a = expected[column][row], b = transform.WorldTransform[column][row];
+					matches &= std::abs(a - b) <= 1e-3f * std::max(1.0f, std::max(std::abs(a), std::abs(b)));
+				}
+			}
+
+			HZ_CORE_ASSERT(matches, "TransformComponent of entity {0} was modified without PatchComponent, its WorldTransform is stale!", (uint32_t)entity);
+		}
+	}
+#endif
+
+	void Scene::PropagateHierarchyTransforms()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		// 存储按深度排序，遍历到子节点时父节点的世界矩阵总是已经更新
+		auto view = m_Registry.view<RelationshipComponent>();
+		for (entt::entity entity : view)
+		{
+			auto& relationship = view.get<RelationshipComponent>(entity);
+			auto& transform = m_Registry.get<TransformComponent>(entity);
+
+			bool changed = false;
+			if (relationship.LocalDirty)
+			{
+				// 变换内核刚把 TRS 计算到 WorldTransform 中
+				relationship.LocalTransform = transform.WorldTransform;
+				relationship.LocalDirty = false;
+				changed = true;
+			}
+
+			if (relationship.Parent != entt::null)
+			{
+				changed |= m_Registry.get<RelationshipComponent>(relationship.Parent).WorldChanged;
+				if (changed)
+				{
+					transform.WorldTransform = m_Registry.get<TransformComponent>(relationship.Parent).WorldTransform * relationship.LocalTransform;
+					// 只有父节点移动时实体本身没有被 patch，需要单独通知保留的精灵缓存与包围盒
+					OnSpriteUpdate(m_Registry, entity);
+					MarkCullingProxyDirty(entity);
+				}
+			}
+
+			relationship.WorldChanged = changed;
+		}
+	}
+
+	void Scene::OnTransformChanged(entt::registry& registry, entt::entity entity)
+	{
+		// 不按 Dirty 去重：replace 会把源组件的 Dirty 一起复制过来，此时实体并不在列表中
+		registry.get<TransformComponent>(entity).Dirty = true;
+		m_DirtyTransforms.push_back(entity);
+	}
+
+	void Scene::OnCircleConstruct(entt::registry& registry, entt::entity entity)
+	{
+		registry.get_or_emplace<CullingProxyComponent>(entity);
+	}
+
+	void Scene::OnCircleDestroy(entt::registry& registry, entt::entity entity)
+	{
+		// 回调在组件移除之前触发，精灵还需要逐帧绘制时保留包围盒
+		auto* retained = registry.try_get<RetainedSpriteComponent>(entity);
+		if (!retained || retained->Retained)
+			registry.remove_if_exists<CullingProxyComponent>(entity);
+	}
+
+	void Scene::OnCullingProxyConstruct(entt::registry& registry, entt::entity entity)
+	{
+		// 包围盒在下一次绘制前插入，此时变换可能还没有设置
+		MarkCullingProxyDirty(entity);
+	}
+
+	void Scene::OnCullingProxyDestroy(entt::registry& registry, entt::entity entity)
+	{
+		auto& proxy = registry.get<CullingProxyComponent>(entity);
+		if (proxy.Proxy != DynamicAABBTree::NullNode)
+			m_CullingTree.DestroyProxy(proxy.Proxy);
+	}
+
+	void Scene::UpdateRetainedSprites()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		for (entt::entity entity : m_DirtySprites)
+		{
+			// 标记之后实体或精灵可能已经被销毁
+			if (!m_Registry.valid(entity))
+				continue;
+
+			auto* retained = m_Registry.try_get<RetainedSpriteComponent>(entity);
+			if (!retained || !retained->Dirty)
+				continue;
+
+			retained->Dirty = false;
+
+			auto [transform, sprite] = m_Registry.get<TransformComponent, SpriteRendererComponent>(entity);
+			retained->Retained = m_RetainedSprites.SetSprite(retained->Slot, transform.WorldTransform, sprite, (int)entity);
+
+			// 只有逐帧绘制的精灵需要剔除，同一实体上的 Circle 仍然需要包围盒
+			if (!retained->Retained)
+				m_Registry.get_or_emplace<CullingProxyComponent>(entity);
+			else if (!m_Registry.has<CircleRendererComponent>(entity))
+				m_Registry.remove_if_exists<CullingProxyComponent>(entity);
+		}
+		m_DirtySprites.clear();
+	}
+
+	void Scene::OnSpriteConstruct(entt::registry& registry, entt::entity entity)
+	{
+		// 实例在下一次绘制前生成，此时精灵数据可能还没有设置
+		registry.emplace<RetainedSpriteComponent>(entity);
+		m_DirtySprites.push_back(entity);
+	}
+
+	void Scene::OnSpriteDestroy(entt::registry& registry, entt::entity entity)
+	{
+		registry.remove_if_exists<RetainedSpriteComponent>(entity);
+
+		// 回调在组件移除之前触发，Circle 也不存在时才移除包围盒
+		if (!registry.has<CircleRendererComponent>(entity))
+			registry.remove_if_exists<CullingProxyComponent>(entity);
+	}
+
+	void Scene::OnSpriteUpdate(entt::registry& registry, entt::entity entity)
+	{
+		auto* retained = registry.try_get<RetainedSpriteComponent>(entity);
+		if (!retained || retained->Dirty)
+			return;
+
+		retained->Dirty = true;
+		m_DirtySprites.push_back(entity);
+	}
+
+	void Scene::OnRetainedSpriteDestroy(entt::registry& registry, entt::entity entity)
+	{
+		auto& retained = registry.get<RetainedSpriteComponent>(entity);
+		if (retained.Slot != Renderer2D::RetainedBatch::InvalidSlot)
+			m_RetainedSprites.Free(retained.Slot);
 	}
 
 	template<typename T>
@@ -5,12 +5,30 @@
 #include "Hazel/Renderer/EditorCamera.h"
 #include "Hazel/Core/Timestep.h"
 #include "Hazel/Core/UUID.h"
+#include "Hazel/Math/DynamicAABBTree.h"
+#include "Hazel/Renderer/Renderer2D.h"
+#include "Hazel/Scene/SystemScheduler.h"
+#include "Hazel/Scene/UUIDIndex.h"
 
 class b2World;
+class b2Body;
 
 namespace Hazel {
 
 	class Entity;
+	struct TransformComponent;
+	struct RelationshipComponent;
+
+	/** 物理按固定步长推进，与帧率无关；绘制时在最近两步的状态之间插值 */
+	struct PhysicsSettings
+	{
+		float FixedTimestep = 1.0f / 60.0f;
+		/** 每帧最多推进的步数，卡顿时丢弃超出的时间，避免步数越积越多 */
+		uint32_t MaxSubsteps = 8;
+		int32_t VelocityIterations = 6;
+		int32_t PositionIterations = 2;
+		bool Interpolate = true;
+	};
 
 	class Scene
 	{
@@ -24,6 +42,9 @@ namespace Hazel {
 		Entity CreateEntityWithUUID(UUID uuid, const std::string& name = std::string());
 		void DestroyEntity(Entity entity);
 
+		/** 通过 UUID 查找实体，不存在时返回空实体 */
+		Entity GetEntityByUUID(UUID uuid);
+
 		/** 运行时启动 */
 		void OnRuntimeStart();
 		/** 运行时结束 */
@@ -40,10 +61,27 @@ namespace Hazel {
 		void OnUpdateEditor(Timestep ts, EditorCamera& camera);
 		void OnViewportResize(uint32_t width, uint32_t height);
 
+		/** 复制实体及其整个子树，副本挂在原实体的父节点下 */
 		void DuplicateEntity(Entity entity);
 
+		/**
+		* 把 child 挂到 parent 下，parent 为空时成为根节点
+		* child 的 TRS 保持不变并解释为相对新父节点的局部变换；parent 不能是 child 自身或其后代
+		*/
+		void SetParent(Entity child, Entity parent);
+		/** 没有父节点时返回空实体 */
+		Entity GetParent(Entity entity);
+		/** 在父节点子链表中的位置，根节点返回 0 */
+		uint32_t GetSiblingIndex(Entity entity);
+
 		Entity GetPrimaryCameraEntity();
 
+		PhysicsSettings& GetPhysicsSettings() { return m_PhysicsSettings; }
+		const PhysicsSettings& GetPhysicsSettings() const { return m_PhysicsSettings; }
+
+		/** 运行时每帧执行的系统及其上一帧的耗时 */
+		const SystemScheduler& GetRuntimeSystems() const { return m_RuntimeSystems; }
+
 		template<typename... Components>
 		auto GetAllEntitiesWith()
 		{
@@ -55,16 +93,111 @@ namespace Hazel {
 
 		void OnPhysics2DStart();
 		void OnPhysics2DStop();
+		/** 把本帧的时间加入累积量，按固定步长推进若干步 */
+		void StepPhysics(Timestep ts);
+		/** 把插值后的刚体状态写回 TransformComponent，只处理上一次推进时在运动的刚体 */
+		void WritebackPhysics();
 
 		void RenderScene(EditorCamera& camera);
+
+		/**
+		* 把 OnUpdateRuntime 的各个阶段注册为系统，声明各自读写的组件
+		* 现有的阶段前后依赖（脚本独占，物理推进 → 写回 → 世界矩阵 → 相机 → 绘制），调度器按顺序执行它们，
+		* 并行只发生在阶段内部（变换内核、精灵提交）；之后新增的系统只要读写不冲突，就会与这些阶段同时执行
+		*/
+		void RegisterRuntimeSystems();
+
+		/** 批量重新计算被 patch 过的 TransformComponent::WorldTransform，每帧在绘制前调用一次 */
+		void UpdateWorldTransforms();
+		/** TransformComponent 的 on_construct / on_update 回调 */
+		void OnTransformChanged(entt::registry& registry, entt::entity entity);
+		/** 按深度从根到叶依次把父节点的世界矩阵乘到子节点上 */
+		void PropagateHierarchyTransforms();
+#ifdef HZ_ENABLE_ASSERTS
+		/**
+		* 轮流抽查一部分未被标记的变换，重新计算世界矩阵并与缓存比较
+		* 直接通过引用修改 TRS 而没有 patch 时缓存不会更新，在这里断言，而不是悄悄地绘制旧的矩阵
+		*/
+		void ValidateWorldTransforms();
+#endif
+
+		/** 只有索引仍然指向 entity 时才移除它的 UUID */
+		void EraseFromEntityIndex(entt::entity entity);
+
+		RelationshipComponent& GetOrAddRelationship(entt::entity entity);
+		/** 从父节点的子链表中摘除，entity 成为根节点 */
+		void DetachFromParent(entt::entity entity);
+		/** entity 及其所有后代，父节点总是排在子节点之前 */
+		void CollectSubtree(entt::entity entity, std::vector<entt::entity>& outEntities);
+		Entity DuplicateSubtree(Entity entity, Entity parent);
+
+		/** 剔除视锥外的实体后绘制 Sprite 与 Circle，需要在 Renderer2D::BeginScene / EndScene 之间调用 */
+		void DrawRenderables(const glm::mat4& viewProjection);
+		/** 为新的可渲染实体插入包围盒，并更新世界矩阵发生变化的实体的包围盒，只访问被标记的实体 */
+		void UpdateCullingProxies();
+		/** 世界矩阵变化后调用，实体没有包围盒时忽略 */
+		void MarkCullingProxyDirty(entt::entity entity);
+
+		void OnCircleConstruct(entt::registry& registry, entt::entity entity);
+		void OnCircleDestroy(entt::registry& registry, entt::entity entity);
+		void OnCullingProxyConstruct(entt::registry& registry, entt::entity entity);
+		void OnCullingProxyDestroy(entt::registry& registry, entt::entity entity);
+
+		/** 重新生成被标记为脏的精灵实例并分配槽位，半透明或没能进入保留缓存的精灵改为参与剔除 */
+		void UpdateRetainedSprites();
+
+		void OnSpriteConstruct(entt::registry& registry, entt::entity entity);
+		void OnSpriteDestroy(entt::registry& registry, entt::entity entity);
+		/** TransformComponent / SpriteRendererComponent 的 on_update 回调 */
+		void OnSpriteUpdate(entt::registry& registry, entt::entity entity);
+		void OnRetainedSpriteDestroy(entt::registry& registry, entt::entity entity);
 	private:
+		// 需要在 m_Registry 之前构造、之后析构，组件的销毁回调会访问它
+		DynamicAABBTree m_CullingTree;
+		std::vector<uint32_t> m_VisibleEntities;
+		/** 新插入或世界矩阵变化的包围盒，以组件的 Dirty 去重 */
+		std::vector<entt::entity> m_DirtyCullingProxies;
+
+		Renderer2D::RetainedBatch m_RetainedSprites;
+		std::vector<entt::entity> m_DirtySprites;
+		/** 多线程提交精灵时每个任务填充的批次，只在 DrawRenderables 期间持有数据 */
+		std::vector<Renderer2D::ThreadBatch> m_SpriteBatches;
+
+		/** 可能有重复，以组件的 Dirty 为准 */
+		std::vector<entt::entity> m_DirtyTransforms;
+		std::vector<TransformComponent*> m_TransformUpdateBuffer;
+
+		/** 层级结构变化后需要重新按深度排序组件存储 */
+		bool m_HierarchyOrderDirty = false;
+		/** 本帧有层级中的变换被 patch 过，需要向下传播 */
+		bool m_HierarchyTransformsDirty = false;
+#ifdef HZ_ENABLE_ASSERTS
+		/** 下一次抽查从变换存储中的这个位置开始 */
+		size_t m_TransformValidationCursor = 0;
+#endif
+
 		entt::registry m_Registry;
+		/** 由 CreateEntityWithUUID / DestroyEntity 维护 */
+		UUIDIndex m_EntityIndex;
 		uint32_t m_ViewportWidth = 0, m_ViewportHeight = 0;
 
 		b2World* m_PhysicsWorld = nullptr;
+		PhysicsSettings m_PhysicsSettings;
+		/** 还没有推进的时间，总是小于一个固定步长（超过步数上限的帧除外） */
+		float m_PhysicsAccumulator = 0.0f;
+		/** 非静态刚体，静态刚体不会移动，不参与写回 */
+		std::vector<b2Body*> m_MovableBodies;
+		/** 上一次推进时醒着、刚被唤醒或刚进入休眠的刚体 */
+		std::vector<b2Body*> m_MovingBodies;
+
+		SystemScheduler m_RuntimeSystems;
+		// 相机系统的结果，供之后的绘制系统使用
+		Camera* m_RuntimeCamera = nullptr;
+		glm::mat4 m_RuntimeCameraTransform = glm::mat4(1.0f);
 
 		friend class Entity;
 		friend class SceneSerializer;
+		friend class SceneSnapshot;
 		friend class SceneHierarchyPanel;
 	};
 }
@@ -168,6 +168,18 @@ namespace Hazel {
 			out << YAML::EndMap; // TransformComponent
 		}
 
+		// 只保存父节点与兄弟节点中的位置，子链表与深度在加载时由 Scene::SetParent 重建
+		if (Entity parent = entity.GetParent())
+		{
+			out << YAML::Key << "RelationshipComponent";
+			out << YAML::BeginMap; // RelationshipComponent
+
+			out << YAML::Key << "Parent" << YAML::Value << parent.GetUUID();
+			out << YAML::Key << "SiblingIndex" << YAML::Value << entity.GetSiblingIndex();
+
+			out << YAML::EndMap; // RelationshipComponent
+		}
+
 		if (entity.HasComponent<CameraComponent>())
 		{
 			out << YAML::Key << "CameraComponent";
@@ -269,6 +281,17 @@ namespace Hazel {
 		YAML::Emitter out;
 		out << YAML::BeginMap;
 		out << YAML::Key << "Scene" << YAML::Value << "Untitled";
+
+		const auto& physics = m_Scene->GetPhysicsSettings();
+		out << YAML::Key << "Physics";
+		out << YAML::BeginMap; // Physics
+		out << YAML::Key << "FixedTimestep" << YAML::Value << physics.FixedTimestep;
+		out << YAML::Key << "MaxSubsteps" << YAML::Value << physics.MaxSubsteps;
+		out << YAML::Key << "VelocityIterations" << YAML::Value << physics.VelocityIterations;
+		out << YAML::Key << "PositionIterations" << YAML::Value << physics.PositionIterations;
+		out << YAML::Key << "Interpolate" << YAML::Value << physics.Interpolate;
+		out << YAML::EndMap; // Physics
+
 		out << YAML::Key << "Entities" << YAML::Value << YAML::BeginSeq;
 		m_Scene->m_Registry.each([&](auto entityID)
 		{
@@ -310,9 +333,29 @@ namespace Hazel {
 		std::string sceneName = data["Scene"].as<std::string>();
 		HZ_CORE_TRACE("Deserializing scene '{0}'", sceneName);
 
+		// 旧的场景文件没有物理设置，使用默认值
+		if (auto physicsNode = data["Physics"])
+		{
+			auto& physics = m_Scene->GetPhysicsSettings();
+			physics.FixedTimestep = physicsNode["FixedTimestep"].as<float>();
+			physics.MaxSubsteps = physicsNode["MaxSubsteps"].as<uint32_t>();
+			physics.VelocityIterations = physicsNode["VelocityIterations"].as<int32_t>();
+			physics.PositionIterations = physicsNode["PositionIterations"].as<int32_t>();
+			physics.Interpolate = physicsNode["Interpolate"].as<bool>();
+		}
+
 		auto entities = data["Entities"];
 		if (entities)
 		{
+			// 父节点可能排在子节点之后，所有实体创建完成后再通过场景的 UUID 索引建立层级
+			struct ParentLink
+			{
+				Entity Child;
+				UUID Parent;
+				uint32_t SiblingIndex;
+			};
+			std::vector<ParentLink> parentLinks;
+
 			for (auto entity : entities)
 			{
 				uint64_t uuid = entity["Entity"].as<uint64_t>();
@@ -336,6 +379,14 @@ namespace Hazel {
 					tc.Scale = transformComponent["Scale"].as<glm::vec3>();
 				}
 
+				auto relationshipComponent = entity["RelationshipComponent"];
+				if (relationshipComponent)
+				{
+					// 旧的场景文件没有 SiblingIndex，按文件中的顺序
+					auto siblingIndex = relationshipComponent["SiblingIndex"];
+					parentLinks.push_back({ deserializedEntity, relationshipComponent["Parent"].as<uint64_t>(), siblingIndex ? siblingIndex.as<uint32_t>() : 0 });
+				}
+
 				auto cameraComponent = entity["CameraComponent"];
 				if (cameraComponent)
 				{
@@ -404,6 +455,21 @@ namespace Hazel {
 					cc2d.RestitutionThreshold = circleCollider2DComponent["RestitutionThreshold"].as<float>();
 				}
 			}
+
+			// SetParent 把子节点插入到子链表的头部，按位置从后往前挂接，兄弟节点的顺序与保存时相同
+			std::stable_sort(parentLinks.begin(), parentLinks.end(), [](const ParentLink& lhs, const ParentLink& rhs) { return lhs.SiblingIndex > rhs.SiblingIndex; });
+
+			for (ParentLink& link : parentLinks)
+			{
+				Entity parent = m_Scene->GetEntityByUUID(link.Parent);
+				if (!parent)
+				{
+					HZ_CORE_WARNING("Parent {0} of entity '{1}' not found", (uint64_t)link.Parent, link.Child.GetName());
+					continue;
+				}
+
+				m_Scene->SetParent(link.Child, parent);
+			}
 		}
 
 		return true;
@@ -0,0 +1,192 @@
+#include "hzpch.h"
+#include "Hazel/Scene/SceneSnapshot.h"
+
+#include "Hazel/Scene/Components.h"
+
+#include <cstring>
+
+namespace Hazel {
+
+	static constexpr size_t s_SnapshotPageSize = 1024;
+
+	template<typename Component>
+	struct SnapshotPage
+	{
+		std::vector<entt::entity> Entities;
+		std::vector<Component> Components;
+	};
+
+	// 不能逐字节比较的组件单独比较，没有提供比较的组件（如 CameraComponent）每次都复制
+	static bool ComponentsEqual(const TagComponent* a, const TagComponent* b, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			if (a[i].Tag != b[i].Tag)
+				return false;
+		}
+		return true;
+	}
+
+	static bool ComponentsEqual(const SpriteRendererComponent* a, const SpriteRendererComponent* b, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			if (a[i].Color != b[i].Color || a[i].Texture != b[i].Texture || a[i].TilingFactor != b[i].TilingFactor)
+				return false;
+		}
+		return true;
+	}
+
+	template<typename Component>
+	static bool ComponentsEqual(const Component* a, const Component* b, size_t count)
+	{
+		// 填充字节不同只会让这一页多复制一次
+		if constexpr (std::is_trivially_copyable_v<Component>)
+			return std::memcmp(a, b, count * sizeof(Component)) == 0;
+		else
+			return false;
+	}
+
+	Ref<SceneSnapshot> SceneSnapshot::Capture(Ref<Scene> scene, Ref<SceneSnapshot> previous)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		Ref<SceneSnapshot> snapshot = CreateRef<SceneSnapshot>();
+		snapshot->m_PhysicsSettings = scene->m_PhysicsSettings;
+		snapshot->m_ViewportWidth = scene->m_ViewportWidth;
+		snapshot->m_ViewportHeight = scene->m_ViewportHeight;
+		snapshot->m_HierarchyOrderDirty = scene->m_HierarchyOrderDirty;
+
+		const entt::registry& registry = scene->m_Registry;
+
+		const entt::entity* entities = registry.data();
+		const size_t entityCount = registry.size();
+		const size_t entityBytes = entityCount * sizeof(entt::entity);
+		if (previous && previous->m_Entities->size() == entityCount && std::memcmp(previous->m_Entities->data(), entities, entityBytes) == 0)
+		{
+			snapshot->m_Entities = previous->m_Entities;
+		}
+		else
+		{
+			snapshot->m_Entities = CreateRef<const std::vector<entt::entity>>(entities, entities + entityCount);
+			snapshot->m_OwnedBytes += entityBytes;
+		}
+		snapshot->m_TotalBytes += entityBytes;
+
+		// 与 Scene::Copy 复制相同的组件，剔除代理与保留精灵在恢复时由回调重新创建
+		snapshot->CapturePools<IDComponent, TagComponent, RelationshipComponent>(registry, previous.get());
+		snapshot->CapturePools(AllComponents{}, registry, previous.get());
+
+		return snapshot;
+	}
+
+	Ref<Scene> SceneSnapshot::Restore() const
+	{
+		HZ_PROFILE_FUNCTION();
+
+		Ref<Scene> scene = CreateRef<Scene>();
+		scene->m_PhysicsSettings = m_PhysicsSettings;
+		scene->m_ViewportWidth = m_ViewportWidth;
+		scene->m_ViewportHeight = m_ViewportHeight;
+		scene->m_HierarchyOrderDirty = m_HierarchyOrderDirty;
+
+		entt::registry& registry = scene->m_Registry;
+		registry.assign(m_Entities->data(), m_Entities->data() + m_Entities->size());
+
+		size_t poolIndex = 0;
+		RestorePools<IDComponent, TagComponent, RelationshipComponent>(registry, poolIndex);
+		RestorePools(AllComponents{}, registry, poolIndex);
+
+		// UUID 索引不在快照中，按 IDComponent 重新建立
+		scene->m_EntityIndex.Reserve(registry.size<IDComponent>());
+		for (auto entity : registry.view<IDComponent>())
+			scene->m_EntityIndex.Insert(registry.get<IDComponent>(entity).ID, entity);
+
+		// 脚本实例属于捕获时的场景，恢复后的场景在第一次更新时重新创建
+		for (auto entity : registry.view<NativeScriptComponent>())
+			registry.get<NativeScriptComponent>(entity).Instance = nullptr;
+
+		return scene;
+	}
+
+	template<typename Component>
+	void SceneSnapshot::CapturePool(const entt::registry& registry, const SceneSnapshot* previous)
+	{
+		const size_t poolIndex = m_Pools.size();
+		std::vector<Ref<const void>>& pages = m_Pools.emplace_back();
+		const std::vector<Ref<const void>>* previousPages = previous ? &previous->m_Pools[poolIndex] : nullptr;
+
+		const size_t count = registry.size<Component>();
+		if (count == 0)
+			return;
+
+		const entt::entity* entities = registry.data<Component>();
+		const Component* components = registry.raw<Component>();
+		pages.reserve((count + s_SnapshotPageSize - 1) / s_SnapshotPageSize);
+
+		for (size_t first = 0; first < count; first += s_SnapshotPageSize)
+		{
+			const size_t pageIndex = first / s_SnapshotPageSize;
+			const size_t pageCount = std::min(count - first, s_SnapshotPageSize);
+			const size_t bytes = pageCount * (sizeof(entt::entity) + sizeof(Component));
+			m_TotalBytes += bytes;
+			m_PageCount++;
+
+			// 同一位置的页中实体顺序与组件数据都没有变化时共享
+			if (previousPages && pageIndex < previousPages->size())
+			{
+				const Ref<const void>& previousPage = (*previousPages)[pageIndex];
+				const auto& page = *static_cast<const SnapshotPage<Component>*>(previousPage.get());
+				if (page.Entities.size() == pageCount
+					&& std::memcmp(page.Entities.data(), entities + first, pageCount * sizeof(entt::entity)) == 0
+					&& ComponentsEqual(page.Components.data(), components + first, pageCount))
+				{
+					pages.push_back(previousPage);
+					m_SharedPageCount++;
+					continue;
+				}
+			}
+
+			Ref<SnapshotPage<Component>> page = CreateRef<SnapshotPage<Component>>();
+			page->Entities.assign(entities + first, entities + first + pageCount);
+			page->Components.assign(components + first, components + first + pageCount);
+			pages.push_back(page);
+			m_OwnedBytes += bytes;
+		}
+	}
+
+	template<typename... Component>
+	void SceneSnapshot::CapturePools(const entt::registry& registry, const SceneSnapshot* previous)
+	{
+		(CapturePool<Component>(registry, previous), ...);
+	}
+
+	template<typename... Component>
+	void SceneSnapshot::CapturePools(ComponentGroup<Component...>, const entt::registry& registry, const SceneSnapshot* previous)
+	{
+		CapturePools<Component...>(registry, previous);
+	}
+
+	template<typename... Component>
+	void SceneSnapshot::RestorePools(entt::registry& registry, size_t& poolIndex) const
+	{
+		([&]()
+		{
+			// 按页的顺序插入，组件存储的顺序与捕获时相同
+			for (const Ref<const void>& pageData : m_Pools[poolIndex])
+			{
+				const auto& page = *static_cast<const SnapshotPage<Component>*>(pageData.get());
+				const size_t count = page.Entities.size();
+				registry.insert<Component>(page.Entities.data(), page.Entities.data() + count, page.Components.data(), page.Components.data() + count);
+			}
+			poolIndex++;
+		}(), ...);
+	}
+
+	template<typename... Component>
+	void SceneSnapshot::RestorePools(ComponentGroup<Component...>, entt::registry& registry, size_t& poolIndex) const
+	{
+		RestorePools<Component...>(registry, poolIndex);
+	}
+
+}
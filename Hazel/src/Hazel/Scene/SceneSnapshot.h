@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Hazel/Scene/Scene.h"
+
+namespace Hazel {
+
+	template<typename... Component>
+	struct ComponentGroup;
+
+	/**
+	* 场景快照，用于运行时回退与重放调试
+	* 每种组件的存储按固定数量的实体切成页，捕获时与上一个快照同一位置的页逐页比较，内容相同就直接共享（去重），
+	* 只为发生了变化的页分配内存，连续的快照之间大部分页是共享的。
+	* 这不是写时复制：捕获时仍要读取并比较整个组件存储，节省的是快照占用的内存，而不是捕获的时间。
+	* 进入运行模式仍然通过 Scene::Copy 完整复制编辑器场景：entt 的组件存储是 registry 独占的连续数组，
+	* 运行时场景无法与编辑器场景共享其中的页，而脚本可以通过组件引用直接写入，首次写入无法可靠地拦截。
+	* 快照只包含组件数据：刚体速度等 Box2D 内部状态与脚本实例不在其中，恢复后重新创建
+	*/
+	class SceneSnapshot
+	{
+	public:
+		/** previous 不为空时与它逐页比较，内容相同的页共享 */
+		static Ref<SceneSnapshot> Capture(Ref<Scene> scene, Ref<SceneSnapshot> previous = nullptr);
+
+		/** 根据快照建立新的场景，实体编号与捕获时相同；之后需要调用 OnRuntimeStart / OnSimulationStart */
+		Ref<Scene> Restore() const;
+
+		/** 所有页的字节数，也就是 Scene::Copy 需要复制的组件数据量 */
+		size_t GetTotalBytes() const { return m_TotalBytes; }
+		/** 本次捕获新分配的页的字节数，其余的页与之前的快照共享 */
+		size_t GetOwnedBytes() const { return m_OwnedBytes; }
+		uint32_t GetPageCount() const { return m_PageCount; }
+		uint32_t GetSharedPageCount() const { return m_SharedPageCount; }
+	private:
+		template<typename Component>
+		void CapturePool(const entt::registry& registry, const SceneSnapshot* previous);
+		template<typename... Component>
+		void CapturePools(const entt::registry& registry, const SceneSnapshot* previous);
+		template<typename... Component>
+		void CapturePools(ComponentGroup<Component...>, const entt::registry& registry, const SceneSnapshot* previous);
+
+		template<typename... Component>
+		void RestorePools(entt::registry& registry, size_t& poolIndex) const;
+		template<typename... Component>
+		void RestorePools(ComponentGroup<Component...>, entt::registry& registry, size_t& poolIndex) const;
+	private:
+		/** 每种组件一个页列表，页的实际类型由捕获时的组件顺序决定 */
+		std::vector<std::vector<Ref<const void>>> m_Pools;
+		/** registry 的实体列表，包括已销毁、等待复用的编号 */
+		Ref<const std::vector<entt::entity>> m_Entities;
+
+		PhysicsSettings m_PhysicsSettings;
+		uint32_t m_ViewportWidth = 0, m_ViewportHeight = 0;
+		bool m_HierarchyOrderDirty = false;
+
+		size_t m_TotalBytes = 0;
+		size_t m_OwnedBytes = 0;
+		uint32_t m_PageCount = 0;
+		uint32_t m_SharedPageCount = 0;
+	};
+
+}
@@ -14,6 +14,12 @@ namespace Hazel {
 		{
 			return m_Entity.GetComponent<T>();
 		}
+
+		template<typename T, typename... Func>
+		T& PatchComponent(Func&&... func)
+		{
+			return m_Entity.PatchComponent<T>(std::forward<Func>(func)...);
+		}
 	protected:
 		virtual void OnCreate() {}
 		virtual void OnDestroy() {}
@@ -0,0 +1,117 @@
+#include "hzpch.h"
+#include "Hazel/Scene/SystemScheduler.h"
+
+#include "Hazel/Core/JobSystem.h"
+#include "Hazel/Core/Timer.h"
+
+namespace Hazel {
+
+	SystemScheduler::SystemBuilder SystemScheduler::AddSystem(const std::string& name, const SystemFunction& function)
+	{
+		Scope<System>& system = m_Systems.emplace_back(CreateScope<System>());
+		system->Name = name;
+		system->Function = function;
+		m_GraphDirty = true;
+		return SystemBuilder(*system);
+	}
+
+	void SystemScheduler::Clear()
+	{
+		m_Systems.clear();
+		m_GraphDirty = true;
+	}
+
+	void SystemScheduler::Run(Timestep ts)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		if (m_GraphDirty)
+			BuildGraph();
+
+		for (auto& system : m_Systems)
+			system->RemainingDependencies.store(system->DependencyCount, std::memory_order_relaxed);
+
+		// 其余系统在它们依赖的最后一个系统完成时调度
+		JobCounter counter;
+		for (uint32_t i = 0; i < (uint32_t)m_Systems.size(); i++)
+		{
+			if (m_Systems[i]->DependencyCount == 0)
+				Dispatch(i, ts, counter);
+		}
+
+		JobSystem::Wait(counter);
+	}
+
+	void SystemScheduler::BuildGraph()
+	{
+		// 只与之前添加的冲突系统连边，添加顺序即冲突系统之间的执行顺序
+		for (auto& system : m_Systems)
+		{
+			system->Dependents.clear();
+			system->DependencyCount = 0;
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)m_Systems.size(); i++)
+		{
+			for (uint32_t j = 0; j < i; j++)
+			{
+				if (!Conflicts(*m_Systems[j], *m_Systems[i]))
+					continue;
+
+				m_Systems[j]->Dependents.push_back(i);
+				m_Systems[i]->DependencyCount++;
+			}
+		}
+
+		m_GraphDirty = false;
+	}
+
+	void SystemScheduler::Dispatch(uint32_t index, Timestep ts, JobCounter& counter)
+	{
+		System& system = *m_Systems[index];
+
+		// 后续系统在本任务完成之前调度，counter 不会提前归零
+		JobSystem::Schedule([this, &system, ts, &counter]()
+		{
+			{
+				HZ_PROFILE_SCOPE_DYNAMIC(system.Name.c_str());
+
+				Timer timer;
+				system.Function(ts);
+				system.Milliseconds = timer.ElapsedMillis();
+			}
+
+			for (uint32_t dependent : system.Dependents)
+			{
+				if (m_Systems[dependent]->RemainingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					Dispatch(dependent, ts, counter);
+			}
+		}, &counter, nullptr, system.MainThread ? JobAffinity::MainThread : JobAffinity::Any);
+	}
+
+	bool SystemScheduler::Conflicts(const System& a, const System& b)
+	{
+		if (a.Exclusive || b.Exclusive)
+			return true;
+
+		auto contains = [](const std::vector<std::type_index>& types, const std::type_index& type)
+		{
+			return std::find(types.begin(), types.end(), type) != types.end();
+		};
+
+		for (const auto& type : a.Writes)
+		{
+			if (contains(b.Reads, type) || contains(b.Writes, type))
+				return true;
+		}
+
+		for (const auto& type : b.Writes)
+		{
+			if (contains(a.Reads, type))
+				return true;
+		}
+
+		return false;
+	}
+
+}
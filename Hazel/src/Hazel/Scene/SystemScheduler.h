@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Hazel/Core/Timestep.h"
+
+#include <atomic>
+#include <functional>
+#include <typeindex>
+
+namespace Hazel {
+
+	class JobCounter;
+
+	/**
+	* 场景系统调度器
+	* 每个系统声明读写的组件类型（也可以是任意用作资源标记的类型），
+	* 两个系统之一写入了另一个读写的类型时视为冲突，按添加顺序先后执行；
+	* 其余系统在 JobSystem 上并行执行。系统内部可以再用 JobSystem::ParallelFor 分块处理实体。
+	*/
+	class SystemScheduler
+	{
+	public:
+		using SystemFunction = std::function<void(Timestep)>;
+
+		struct System
+		{
+			std::string Name;
+			SystemFunction Function;
+			std::vector<std::type_index> Reads;
+			std::vector<std::type_index> Writes;
+			/** 与所有系统冲突，例如可以访问任意组件的脚本 */
+			bool Exclusive = false;
+			/** 只在主线程执行，用于 OpenGL 调用或 GLFW 输入 */
+			bool MainThread = false;
+
+			/** 上一次执行的耗时 */
+			float Milliseconds = 0.0f;
+
+			// 依赖图，系统增删后重新建立
+			std::vector<uint32_t> Dependents;
+			uint32_t DependencyCount = 0;
+			std::atomic<uint32_t> RemainingDependencies = 0;
+		};
+
+		class SystemBuilder
+		{
+		public:
+			template<typename... T>
+			SystemBuilder& Reads() { (m_System.Reads.emplace_back(typeid(T)), ...); return *this; }
+
+			template<typename... T>
+			SystemBuilder& Writes() { (m_System.Writes.emplace_back(typeid(T)), ...); return *this; }
+
+			SystemBuilder& Exclusive() { m_System.Exclusive = true; return *this; }
+			SystemBuilder& MainThread() { m_System.MainThread = true; return *this; }
+		private:
+			SystemBuilder(System& system) : m_System(system) {}
+		private:
+			System& m_System;
+
+			friend class SystemScheduler;
+		};
+
+		/** 添加一个系统，通过返回值声明它访问的组件 */
+		SystemBuilder AddSystem(const std::string& name, const SystemFunction& function);
+		void Clear();
+
+		/** 按依赖关系执行所有系统，全部完成后返回；有主线程系统时需要在主线程上调用 */
+		void Run(Timestep ts);
+
+		const std::vector<Scope<System>>& GetSystems() const { return m_Systems; }
+	private:
+		void BuildGraph();
+		void Dispatch(uint32_t index, Timestep ts, JobCounter& counter);
+		static bool Conflicts(const System& a, const System& b);
+	private:
+		std::vector<Scope<System>> m_Systems;
+		bool m_GraphDirty = true;
+	};
+
+}
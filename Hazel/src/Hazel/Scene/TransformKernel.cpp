@@ -0,0 +1,136 @@
+#include "hzpch.h"
+#include "Hazel/Scene/TransformKernel.h"
+
+#include "Hazel/Scene/Components.h"
+
+#include <immintrin.h>
+
+namespace Hazel {
+
+	namespace Utils {
+
+		/**
+		* 同时计算 4 个角度的 sin / cos
+		* 先归约到 [-π, π]，再利用 sin(π - x) = sin(x)、cos(π - x) = -cos(x) 折回 [-π/2, π/2]，
+		* 最后用 11 / 12 阶泰勒多项式，区间内误差小于 1e-7
+		*/
+		static void SinCos4(__m128 x, __m128& outSin, __m128& outCos)
+		{
+			const __m128 signMask = _mm_set1_ps(-0.0f);
+
+			// x -= 2π * round(x / 2π)
+			__m128 k = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.159154943f))));
+			x = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(6.28318531f)));
+
+			__m128 sign = _mm_and_ps(x, signMask);
+			__m128 absX = _mm_andnot_ps(signMask, x);
+			__m128 fold = _mm_cmpgt_ps(absX, _mm_set1_ps(1.57079633f));
+			__m128 folded = _mm_or_ps(_mm_sub_ps(_mm_set1_ps(3.14159265f), absX), sign);
+			x = _mm_or_ps(_mm_and_ps(fold, folded), _mm_andnot_ps(fold, x));
+
+			__m128 x2 = _mm_mul_ps(x, x);
+
+			__m128 s = _mm_set1_ps(-2.5052108e-8f);
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(2.7557319e-6f));
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(-1.9841270e-4f));
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(8.3333333e-3f));
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(-1.6666667e-1f));
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(1.0f));
+			outSin = _mm_mul_ps(s, x);
+
+			__m128 c = _mm_set1_ps(2.0876757e-9f);
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-2.7557319e-7f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(2.4801587e-5f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-1.3888889e-3f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(4.1666667e-2f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-0.5f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(1.0f));
+
+			// 折回过的角度 cos 取反
+			outCos = _mm_xor_ps(c, _mm_and_ps(fold, signMask));
+		}
+
+		static void UpdateWorldTransforms4(TransformComponent* const* t)
+		{
+			// 按分量重新排列，每个寄存器保存 4 个变换的同一分量
+		#define HZ_GATHER(member, axis) _mm_setr_ps(t[0]->member.axis, t[1]->member.axis, t[2]->member.axis, t[3]->member.axis)
+			const __m128 half = _mm_set1_ps(0.5f);
+			__m128 sx, cx, sy, cy, sz, cz;
+			SinCos4(_mm_mul_ps(HZ_GATHER(Rotation, x), half), sx, cx);
+			SinCos4(_mm_mul_ps(HZ_GATHER(Rotation, y), half), sy, cy);
+			SinCos4(_mm_mul_ps(HZ_GATHER(Rotation, z), half), sz, cz);
+
+			const __m128 scaleX = HZ_GATHER(Scale, x);
+			const __m128 scaleY = HZ_GATHER(Scale, y);
+			const __m128 scaleZ = HZ_GATHER(Scale, z);
+		#undef HZ_GATHER
+
+			// glm::quat(eulerAngles)
+			__m128 cxcy = _mm_mul_ps(cx, cy), sxsy = _mm_mul_ps(sx, sy);
+			__m128 sxcy = _mm_mul_ps(sx, cy), cxsy = _mm_mul_ps(cx, sy);
+			__m128 qw = _mm_add_ps(_mm_mul_ps(cxcy, cz), _mm_mul_ps(sxsy, sz));
+			__m128 qx = _mm_sub_ps(_mm_mul_ps(sxcy, cz), _mm_mul_ps(cxsy, sz));
+			__m128 qy = _mm_add_ps(_mm_mul_ps(cxsy, cz), _mm_mul_ps(sxcy, sz));
+			__m128 qz = _mm_sub_ps(_mm_mul_ps(cxcy, sz), _mm_mul_ps(sxsy, cz));
+
+			// glm::mat3_cast，m[列][行]
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 two = _mm_set1_ps(2.0f);
+			__m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+			__m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+			__m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+			__m128 m00 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+			__m128 m01 = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+			__m128 m02 = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+			__m128 m10 = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+			__m128 m11 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+			__m128 m12 = _mm_mul_ps(two, _mm_add_ps(yz, wx));
+			__m128 m20 = _mm_mul_ps(two, _mm_add_ps(xz, wy));
+			__m128 m21 = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+			__m128 m22 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+
+			// T * R * S：旋转矩阵的每一列乘以对应的缩放
+			__m128 col0[4] = { _mm_mul_ps(m00, scaleX), _mm_mul_ps(m01, scaleX), _mm_mul_ps(m02, scaleX), _mm_setzero_ps() };
+			__m128 col1[4] = { _mm_mul_ps(m10, scaleY), _mm_mul_ps(m11, scaleY), _mm_mul_ps(m12, scaleY), _mm_setzero_ps() };
+			__m128 col2[4] = { _mm_mul_ps(m20, scaleZ), _mm_mul_ps(m21, scaleZ), _mm_mul_ps(m22, scaleZ), _mm_setzero_ps() };
+
+			// 转置后第 i 个寄存器就是第 i 个变换的一列
+			_MM_TRANSPOSE4_PS(col0[0], col0[1], col0[2], col0[3]);
+			_MM_TRANSPOSE4_PS(col1[0], col1[1], col1[2], col1[3]);
+			_MM_TRANSPOSE4_PS(col2[0], col2[1], col2[2], col2[3]);
+
+			for (int i = 0; i < 4; i++)
+			{
+				glm::mat4& m = t[i]->WorldTransform;
+				_mm_storeu_ps(&m[0][0], col0[i]);
+				_mm_storeu_ps(&m[1][0], col1[i]);
+				_mm_storeu_ps(&m[2][0], col2[i]);
+				m[3] = glm::vec4(t[i]->Translation, 1.0f);
+			}
+		}
+
+	}
+
+	void TransformKernel::UpdateWorldTransforms(TransformComponent* const* transforms, uint32_t count)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		uint32_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			Utils::UpdateWorldTransforms4(transforms + i);
+
+		// 不足 4 个的部分逐个计算
+		for (; i < count; i++)
+			transforms[i]->WorldTransform = transforms[i]->GetTransform();
+	}
+
+	void TransformKernel::UpdateWorldTransformsScalar(TransformComponent* const* transforms, uint32_t count)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		for (uint32_t i = 0; i < count; i++)
+			transforms[i]->WorldTransform = transforms[i]->GetTransform();
+	}
+
+}
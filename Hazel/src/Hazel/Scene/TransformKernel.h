@@ -0,0 +1,22 @@
+#pragma once
+
+namespace Hazel {
+
+	struct TransformComponent;
+
+	/**
+	* 世界矩阵批量计算内核
+	* 每 4 个变换一组，把 TRS 重新排列成 SoA 后用 SSE 同时计算欧拉角 -> 四元数 -> 旋转矩阵，
+	* 再转置写回各自的 WorldTransform；结果与 TransformComponent::GetTransform 一致（误差约 1e-6）。
+	*/
+	class TransformKernel
+	{
+	public:
+		/** 重新计算 transforms 中每个组件的 WorldTransform */
+		static void UpdateWorldTransforms(TransformComponent* const* transforms, uint32_t count);
+
+		/** 逐个调用 GetTransform 的标量实现，用于性能对比 */
+		static void UpdateWorldTransformsScalar(TransformComponent* const* transforms, uint32_t count);
+	};
+
+}
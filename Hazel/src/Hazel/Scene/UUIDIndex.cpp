@@ -0,0 +1,123 @@
+#include "hzpch.h"
+#include "Hazel/Scene/UUIDIndex.h"
+
+namespace Hazel {
+
+	static constexpr size_t s_MinCapacity = 16;
+
+	bool UUIDIndex::Insert(UUID uuid, entt::entity entity)
+	{
+		HZ_CORE_ASSERT(entity != entt::null);
+
+		// 负载不超过 3/4，线性探测的平均查找长度保持在两三个槽位以内
+		if ((m_Size + 1) * 4 > m_Slots.size() * 3)
+			Rehash(std::max(s_MinCapacity, m_Slots.size() * 2));
+
+		const uint64_t key = uuid;
+		const size_t mask = m_Slots.size() - 1;
+		for (size_t i = GetHomeSlot(key);; i = (i + 1) & mask)
+		{
+			Slot& slot = m_Slots[i];
+			if (slot.Entity == entt::null)
+			{
+				slot.Key = key;
+				slot.Entity = entity;
+				m_Size++;
+				return true;
+			}
+
+			if (slot.Key == key)
+			{
+				slot.Entity = entity;
+				return false;
+			}
+		}
+	}
+
+	bool UUIDIndex::Erase(UUID uuid)
+	{
+		size_t hole = FindSlot(uuid);
+		if (hole == m_Slots.size())
+			return false;
+
+		// 后面的元素如果可以放在空出的槽位（它的初始槽位不在空位之后），就前移填补
+		const size_t mask = m_Slots.size() - 1;
+		for (size_t i = (hole + 1) & mask; m_Slots[i].Entity != entt::null; i = (i + 1) & mask)
+		{
+			const size_t home = GetHomeSlot(m_Slots[i].Key);
+			if (((i - home) & mask) >= ((i - hole) & mask))
+			{
+				m_Slots[hole] = m_Slots[i];
+				hole = i;
+			}
+		}
+
+		m_Slots[hole] = Slot();
+		m_Size--;
+		return true;
+	}
+
+	entt::entity UUIDIndex::Find(UUID uuid) const
+	{
+		size_t index = FindSlot(uuid);
+		return index == m_Slots.size() ? entt::null : m_Slots[index].Entity;
+	}
+
+	void UUIDIndex::Reserve(size_t count)
+	{
+		size_t capacity = s_MinCapacity;
+		while (capacity * 3 < count * 4)
+			capacity *= 2;
+
+		if (capacity > m_Slots.size())
+			Rehash(capacity);
+	}
+
+	void UUIDIndex::Clear()
+	{
+		m_Slots.clear();
+		m_Size = 0;
+		m_Shift = 64;
+	}
+
+	size_t UUIDIndex::FindSlot(uint64_t key) const
+	{
+		if (m_Size == 0)
+			return m_Slots.size();
+
+		const size_t mask = m_Slots.size() - 1;
+		for (size_t i = GetHomeSlot(key);; i = (i + 1) & mask)
+		{
+			const Slot& slot = m_Slots[i];
+			if (slot.Entity == entt::null)
+				return m_Slots.size();
+			if (slot.Key == key)
+				return i;
+		}
+	}
+
+	void UUIDIndex::Rehash(size_t capacity)
+	{
+		HZ_CORE_ASSERT((capacity & (capacity - 1)) == 0, "Capacity must be a power of two!");
+
+		std::vector<Slot> slots(capacity);
+		slots.swap(m_Slots);
+
+		m_Shift = 64;
+		for (size_t c = capacity; c > 1; c >>= 1)
+			m_Shift--;
+
+		const size_t mask = capacity - 1;
+		for (const Slot& slot : slots)
+		{
+			if (slot.Entity == entt::null)
+				continue;
+
+			size_t i = GetHomeSlot(slot.Key);
+			while (m_Slots[i].Entity != entt::null)
+				i = (i + 1) & mask;
+			m_Slots[i] = slot;
+		}
+	}
+
+}
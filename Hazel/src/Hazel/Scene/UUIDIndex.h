@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Hazel/Core/UUID.h"
+
+#include "entt.hpp"
+
+#include <vector>
+
+namespace Hazel {
+
+	/**
+	* UUID 到实体的索引（开放寻址、线性探测）
+	* 所有槽位在一个连续数组中，查找通常只访问一两个相邻的槽位，插入与删除不分配单独的节点；
+	* 删除时把同一探测链上后面的元素前移，不留墓碑，查找长度不会随着反复增删而变长
+	*/
+	class UUIDIndex
+	{
+	public:
+		/** 已存在时覆盖原来的实体并返回 false */
+		bool Insert(UUID uuid, entt::entity entity);
+		/** 不存在时返回 false */
+		bool Erase(UUID uuid);
+		/** 不存在时返回 entt::null */
+		entt::entity Find(UUID uuid) const;
+
+		/** 预留至少能容纳 count 个元素的槽位，之后的插入不会重新分配 */
+		void Reserve(size_t count);
+		void Clear();
+
+		size_t GetSize() const { return m_Size; }
+		size_t GetCapacity() const { return m_Slots.size(); }
+	private:
+		struct Slot
+		{
+			uint64_t Key = 0;
+			entt::entity Entity = entt::null; // entt::null 表示空槽位
+		};
+
+		/** Fibonacci 散列，连续分配的 UUID（如网络 ID）也能均匀分布 */
+		size_t GetHomeSlot(uint64_t key) const { return (size_t)((key * 0x9E3779B97F4A7C15ull) >> m_Shift); }
+		/** 不存在时返回 m_Slots.size() */
+		size_t FindSlot(uint64_t key) const;
+		/** capacity 必须是 2 的幂 */
+		void Rehash(size_t capacity);
+	private:
+		std::vector<Slot> m_Slots;
+		size_t m_Size = 0;
+		uint32_t m_Shift = 64;
+	};
+
+}
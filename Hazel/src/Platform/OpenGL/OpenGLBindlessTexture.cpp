@@ -0,0 +1,55 @@
+#include "hzpch.h"
+#include "Platform/OpenGL/OpenGLBindlessTexture.h"
+
+#include <glad/glad.h>
+
+namespace Hazel {
+
+	typedef GLuint64 (APIENTRYP PFNGLGETTEXTUREHANDLEARBPROC)(GLuint texture);
+	typedef void (APIENTRYP PFNGLMAKETEXTUREHANDLERESIDENTARBPROC)(GLuint64 handle);
+	typedef void (APIENTRYP PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC)(GLuint64 handle);
+
+	static PFNGLGETTEXTUREHANDLEARBPROC s_GetTextureHandle = nullptr;
+	static PFNGLMAKETEXTUREHANDLERESIDENTARBPROC s_MakeTextureHandleResident = nullptr;
+	static PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC s_MakeTextureHandleNonResident = nullptr;
+
+	bool OpenGLBindlessTexture::s_Supported = false;
+
+	bool OpenGLBindlessTexture::Load(void* (*getProcAddress)(const char* name))
+	{
+		s_Supported = false;
+
+		GLint extensionCount = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+		bool found = false;
+		for (GLint i = 0; i < extensionCount && !found; i++)
+			found = strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), "GL_ARB_bindless_texture") == 0;
+
+		if (!found)
+			return false;
+
+		s_GetTextureHandle = (PFNGLGETTEXTUREHANDLEARBPROC)getProcAddress("glGetTextureHandleARB");
+		s_MakeTextureHandleResident = (PFNGLMAKETEXTUREHANDLERESIDENTARBPROC)getProcAddress("glMakeTextureHandleResidentARB");
+		s_MakeTextureHandleNonResident = (PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC)getProcAddress("glMakeTextureHandleNonResidentARB");
+
+		s_Supported = s_GetTextureHandle && s_MakeTextureHandleResident && s_MakeTextureHandleNonResident;
+		return s_Supported;
+	}
+
+	uint64_t OpenGLBindlessTexture::MakeResident(uint32_t texture)
+	{
+		HZ_CORE_ASSERT(s_Supported, "GL_ARB_bindless_texture is not supported!");
+
+		// 取得句柄后纹理的采样参数不能再修改，纹理数据仍然可以更新
+		GLuint64 handle = s_GetTextureHandle(texture);
+		s_MakeTextureHandleResident(handle);
+		return handle;
+	}
+
+	void OpenGLBindlessTexture::MakeNonResident(uint64_t handle)
+	{
+		s_MakeTextureHandleNonResident(handle);
+	}
+
+}
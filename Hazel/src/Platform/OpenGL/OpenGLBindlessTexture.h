@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Hazel {
+
+	/**
+	* GL_ARB_bindless_texture
+	* Glad 没有生成这个扩展，由 OpenGLContext 在加载 OpenGL 函数后检测并加载其中用到的函数
+	*/
+	class OpenGLBindlessTexture
+	{
+	public:
+		/** 驱动支持该扩展时加载函数指针，返回是否可用 */
+		static bool Load(void* (*getProcAddress)(const char* name));
+
+		static bool IsSupported() { return s_Supported; }
+
+		/** 返回纹理的 64 位句柄，并使其常驻显存，之后可以直接在着色器中采样 */
+		static uint64_t MakeResident(uint32_t texture);
+		static void MakeNonResident(uint64_t handle);
+	private:
+		static bool s_Supported;
+	};
+
+}
@@ -63,10 +63,10 @@ namespace Hazel {
 		glDeleteBuffers(1, &m_RendererID);
 	}
 
-	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size)
+	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
 	{
 		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+		glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
 	}
 
 	void OpenGLVertexBuffer::Bind() const
@@ -83,6 +83,189 @@ namespace Hazel {
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
+	/////////////////////////////////////////////////////////////////////////////
+	// StreamingVertexBuffer ////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+
+	OpenGLStreamingVertexBuffer::OpenGLStreamingVertexBuffer(uint32_t size, uint32_t bufferCount)
+		: m_Size(size * bufferCount), m_SegmentSize(size)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		HZ_CORE_ASSERT(bufferCount >= 2, "Streaming vertex buffer needs at least two segments!");
+
+		/**
+		* 不可变存储 + 常驻映射：
+		* GL_MAP_PERSISTENT_BIT 允许缓冲在映射状态下被 GPU 使用，之后不再需要 glMapBuffer / glUnmapBuffer；
+		* GL_MAP_COHERENT_BIT 让 CPU 写入对之后发出的绘制命令自动可见，不需要 glFlushMappedBufferRange。
+		*/
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferStorage(m_RendererID, m_Size, nullptr, flags);
+		m_MappedData = (uint8_t*)glMapNamedBufferRange(m_RendererID, 0, m_Size, flags);
+
+		HZ_CORE_ASSERT(m_MappedData, "Failed to map streaming vertex buffer!");
+	}
+
+	OpenGLStreamingVertexBuffer::~OpenGLStreamingVertexBuffer()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		for (auto& range : m_Fences)
+			glDeleteSync((GLsync)range.Sync);
+
+		glUnmapNamedBuffer(m_RendererID);
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLStreamingVertexBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		HZ_CORE_ASSERT(false, "Use Reserve/Commit to write into a streaming vertex buffer!");
+	}
+
+	void* OpenGLStreamingVertexBuffer::Reserve(uint32_t size)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		HZ_CORE_ASSERT(m_Layout.GetStride(), "Streaming vertex buffer has no layout!");
+		HZ_CORE_ASSERT(size <= m_SegmentSize, "Reserve size exceeds the segment size!");
+
+		// 按步长对齐，保证 Commit 返回的偏移能换算成顶点 / 实例序号
+		const uint32_t stride = m_Layout.GetStride();
+		uint32_t offset = (m_Head + stride - 1) / stride * stride;
+		if (offset + size > m_Size)
+			offset = 0;
+
+		WaitForRange(offset, offset + size);
+
+		// 没有栅栏的数据还没有被绘制，不能等待也不能覆盖；调用方按段数限制未插入栅栏的批次（见 Renderer2D 的 static_assert）
+		for (const PendingRange& range : m_PendingRanges)
+			HZ_CORE_ASSERT(!(range.Begin < offset + size && offset < range.End), "Reserve overlaps committed data that has not been fenced!");
+
+		m_ReservedOffset = offset;
+		m_ReservedSize = size;
+		return m_MappedData + offset;
+	}
+
+	uint32_t OpenGLStreamingVertexBuffer::Commit(uint32_t size)
+	{
+		HZ_CORE_ASSERT(size <= m_ReservedSize, "Committed more data than reserved!");
+
+		const uint32_t offset = m_ReservedOffset;
+		if (size)
+		{
+			m_PendingRanges.push_back({ offset, offset + size });
+			m_Head = offset + size;
+		}
+
+		// 同一次 Reserve 只能提交一次
+		m_ReservedSize = 0;
+		return offset;
+	}
+
+	void OpenGLStreamingVertexBuffer::Fence()
+	{
+		if (m_PendingRanges.empty())
+			return;
+
+		// 每个区间一个栅栏，它们在同一位置插入，同时完成
+		for (const PendingRange& range : m_PendingRanges)
+		{
+			GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			m_Fences.push_back({ range.Begin, range.End, sync });
+		}
+		m_PendingRanges.clear();
+	}
+
+	void OpenGLStreamingVertexBuffer::WaitForRange(uint32_t begin, uint32_t end)
+	{
+		// GPU 按提交顺序完成栅栏，只需要等待与该区间重叠的最后一个栅栏，它之前的栅栏也一定已经完成
+		auto last = m_Fences.end();
+		for (auto it = m_Fences.begin(); it != m_Fences.end(); ++it)
+		{
+			if (it->Begin < end && begin < it->End)
+				last = it;
+		}
+
+		if (last == m_Fences.end())
+			return;
+
+		GLsync sync = (GLsync)last->Sync;
+		GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		while (true)
+		{
+			GLenum result = glClientWaitSync(sync, waitFlags, 1000000); // 1ms
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+				break;
+
+			HZ_CORE_ASSERT(result != GL_WAIT_FAILED, "glClientWaitSync failed!");
+			if (result == GL_WAIT_FAILED)
+				break;
+
+			waitFlags = 0;
+		}
+
+		for (auto it = m_Fences.begin(); it != last + 1; ++it)
+			glDeleteSync((GLsync)it->Sync);
+		m_Fences.erase(m_Fences.begin(), last + 1);
+	}
+
+	void OpenGLStreamingVertexBuffer::Bind() const
+	{
+		HZ_PROFILE_FUNCTION();
+
+		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+	}
+
+	void OpenGLStreamingVertexBuffer::Unbind() const
+	{
+		HZ_PROFILE_FUNCTION();
+
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////
+	// IndirectBuffer ///////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+
+	OpenGLIndirectBuffer::OpenGLIndirectBuffer(uint32_t capacity)
+		: m_Capacity(std::max(capacity, 1u))
+	{
+		HZ_PROFILE_FUNCTION();
+
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferData(m_RendererID, m_Capacity * sizeof(DrawArraysIndirectCommand), nullptr, GL_STREAM_DRAW);
+	}
+
+	OpenGLIndirectBuffer::~OpenGLIndirectBuffer()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLIndirectBuffer::SetData(const DrawArraysIndirectCommand* commands, uint32_t count)
+	{
+		if (count > m_Capacity)
+			m_Capacity = std::max(count, m_Capacity * 2);
+
+		// 每次重新分配存储（orphaning），GPU 还在读取的旧命令由驱动保留，不需要等待
+		glNamedBufferData(m_RendererID, m_Capacity * sizeof(DrawArraysIndirectCommand), nullptr, GL_STREAM_DRAW);
+		glNamedBufferSubData(m_RendererID, 0, count * sizeof(DrawArraysIndirectCommand), commands);
+		m_Count = count;
+	}
+
+	void OpenGLIndirectBuffer::Bind() const
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+	}
+
+	void OpenGLIndirectBuffer::Unbind() const
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
 	/////////////////////////////////////////////////////////////////////////////
 	// IndexBuffer //////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////
@@ -2,6 +2,8 @@
 
 #include "Hazel/Renderer/Buffer.h"
 
+#include <deque>
+
 namespace Hazel {
 
 	class OpenGLVertexBuffer : public VertexBuffer
@@ -11,7 +13,7 @@ namespace Hazel {
 		OpenGLVertexBuffer(float* vertices, uint32_t size);
 		virtual ~OpenGLVertexBuffer();
 
-		virtual void SetData(const void* data, uint32_t size) override;
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
 
 		virtual void Bind() const;
 		virtual void Unbind() const;
@@ -23,6 +25,81 @@ namespace Hazel {
 		BufferLayout m_Layout;
 	};
 
+	/**
+	* 基于 glNamedBufferStorage + GL_MAP_PERSISTENT_BIT 的常驻映射缓冲，用 glFenceSync 保护正在被 GPU 读取的区域
+	*/
+	class OpenGLStreamingVertexBuffer : public StreamingVertexBuffer
+	{
+	public:
+		OpenGLStreamingVertexBuffer(uint32_t size, uint32_t bufferCount);
+		virtual ~OpenGLStreamingVertexBuffer();
+
+		/** 常驻映射缓冲的数据偏移由 Commit 决定，不支持从偏移 0 覆盖写入 */
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+
+		virtual void* Reserve(uint32_t size) override;
+		virtual uint32_t Commit(uint32_t size) override;
+		virtual void Fence() override;
+
+		virtual void Bind() const;
+		virtual void Unbind() const;
+
+		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
+		virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+	private:
+		/** 等待 GPU 用完 [begin, end) 区间，并释放所有已经完成的栅栏 */
+		void WaitForRange(uint32_t begin, uint32_t end);
+	private:
+		uint32_t m_RendererID;
+		BufferLayout m_Layout;
+
+		uint8_t* m_MappedData = nullptr;
+		uint32_t m_Size = 0;
+		/** 单次 Reserve 的最大字节数，超过一段时未插入栅栏的区间不重叠的保证不再成立 */
+		uint32_t m_SegmentSize = 0;
+
+		/** 下一次 Reserve 的起点 */
+		uint32_t m_Head = 0;
+		/** 最近一次 Reserve 的起点与大小 */
+		uint32_t m_ReservedOffset = 0;
+		uint32_t m_ReservedSize = 0;
+
+		struct PendingRange
+		{
+			uint32_t Begin;
+			uint32_t End;
+		};
+		/** 已提交但还没有插入栅栏的区间 */
+		std::vector<PendingRange> m_PendingRanges;
+
+		struct FencedRange
+		{
+			uint32_t Begin;
+			uint32_t End;
+			void* Sync; // GLsync
+		};
+		/** 按提交顺序排列，GPU 也按这个顺序完成 */
+		std::deque<FencedRange> m_Fences;
+	};
+
+	class OpenGLIndirectBuffer : public IndirectBuffer
+	{
+	public:
+		OpenGLIndirectBuffer(uint32_t capacity);
+		virtual ~OpenGLIndirectBuffer();
+
+		virtual void Bind() const;
+		virtual void Unbind() const;
+
+		virtual void SetData(const DrawArraysIndirectCommand* commands, uint32_t count) override;
+
+		virtual uint32_t GetCount() const { return m_Count; }
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Capacity;
+		uint32_t m_Count = 0;
+	};
+
 	class OpenGLIndexBuffer : public IndexBuffer
 	{
 	public:
@@ -1,5 +1,6 @@
 #include "hzpch.h"
 #include "Platform/OpenGL/OpenGLContext.h"
+#include "Platform/OpenGL/OpenGLBindlessTexture.h"
 
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
@@ -29,6 +30,9 @@ namespace Hazel {
 		HZ_CORE_INFO("  Version: {0}", (char*)glGetString(GL_VERSION));
 
 		HZ_CORE_ASSERT(GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 5), "Hazel requires at least OpenGL version 4.5!");
+
+		bool bindless = OpenGLBindlessTexture::Load((void* (*)(const char*))glfwGetProcAddress);
+		HZ_CORE_INFO("  Bindless textures: {0}", bindless ? "supported" : "not supported");
 	}
 
 	void OpenGLContext::SwapBuffers()
@@ -1,5 +1,6 @@
 #include "hzpch.h"
 #include "Platform/OpenGL/OpenGLRendererAPI.h"
+#include "Platform/OpenGL/OpenGLBindlessTexture.h"
 
 #include <glad/glad.h>
 
@@ -48,11 +49,39 @@ namespace Hazel {
 		glViewport(x, y, width, height);
 	}
 
+	void OpenGLRendererAPI::GetViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height)
+	{
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		x = (uint32_t)viewport[0];
+		y = (uint32_t)viewport[1];
+		width = (uint32_t)viewport[2];
+		height = (uint32_t)viewport[3];
+	}
+
+	bool OpenGLRendererAPI::SupportsBindlessTextures() const
+	{
+		return OpenGLBindlessTexture::IsSupported();
+	}
+
 	void OpenGLRendererAPI::SetClearColor(const glm::vec4& color)
 	{
 		glClearColor(color.r, color.g, color.b, color.a);
 	}
 
+	void OpenGLRendererAPI::SetBlendEnabled(bool enabled)
+	{
+		if (enabled)
+			glEnable(GL_BLEND);
+		else
+			glDisable(GL_BLEND);
+	}
+
+	void OpenGLRendererAPI::SetDepthWriteEnabled(bool enabled)
+	{
+		glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+	}
+
 	void OpenGLRendererAPI::Clear()
 	{
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -77,15 +106,25 @@ namespace Hazel {
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
 	}
 
-	void OpenGLRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
+	void OpenGLRendererAPI::DrawInstanced(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t instanceCount, uint32_t baseInstance)
 	{
+		HZ_PROFILE_FUNCTION();
+
 		vertexArray->Bind();
-		glDrawArrays(GL_LINES, 0, vertexCount);
+
+		// baseInstance 只影响实例属性（divisor != 0）的读取起点，gl_VertexIndex 仍从 0 开始
+		glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, vertexCount, instanceCount, baseInstance);
 	}
 
-	void OpenGLRendererAPI::SetLineWidth(float width)
+	void OpenGLRendererAPI::MultiDrawInstancedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer)
 	{
-		glLineWidth(width);
+		HZ_PROFILE_FUNCTION();
+
+		vertexArray->Bind();
+		indirectBuffer->Bind();
+
+		// 命令从 GL_DRAW_INDIRECT_BUFFER 的起点开始紧密排列
+		glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, indirectBuffer->GetCount(), 0);
 	}
 
 }
@@ -9,15 +9,18 @@ namespace Hazel {
 	public:
 		virtual void Init() override;
 		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+		virtual void GetViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) override;
+		virtual bool SupportsBindlessTextures() const override;
 
 		virtual void SetClearColor(const glm::vec4& color) override;
+		virtual void SetBlendEnabled(bool enabled) override;
+		virtual void SetDepthWriteEnabled(bool enabled) override;
 		virtual void Clear() override;
 
 		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) override;
 
-		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) override;
-
-		virtual void SetLineWidth(float width) override;
+		virtual void DrawInstanced(const Ref<VertexArray>& vertexArray, uint32_t vertexCount, uint32_t instanceCount, uint32_t baseInstance = 0) override;
+		virtual void MultiDrawInstancedIndirect(const Ref<VertexArray>& vertexArray, const Ref<IndirectBuffer>& indirectBuffer) override;
 	};
 
 
@@ -100,9 +100,17 @@ namespace Hazel {
 
 		{
 			Timer timer;
-			CompileOrGetVulkanBinaries(shaderSources);
-			CompileOrGetOpenGLBinaries();
-			CreateProgram();
+			// SPIR-V 无法表示无绑定纹理的句柄，启用该扩展的着色器直接交给驱动编译 GLSL
+			if (source.find("GL_ARB_bindless_texture") != std::string::npos)
+			{
+				CompileFromSource(shaderSources);
+			}
+			else
+			{
+				CompileOrGetVulkanBinaries(shaderSources);
+				CompileOrGetOpenGLBinaries();
+				CreateProgram();
+			}
 			HZ_CORE_WARNING("Shader creation took {0} ms", timer.ElapsedMillis());
 		}
 
@@ -325,6 +333,41 @@ namespace Hazel {
 			glAttachShader(program, shaderID);
 		}
 
+		LinkProgram(program, shaderIDs);
+	}
+
+	void OpenGLShader::CompileFromSource(const std::unordered_map<GLenum, std::string>& shaderSources)
+	{
+		GLuint program = glCreateProgram();
+
+		std::vector<GLuint> shaderIDs;
+		for (auto&& [stage, source] : shaderSources)
+		{
+			GLuint shaderID = shaderIDs.emplace_back(glCreateShader(stage));
+			const GLchar* sourceCStr = source.c_str();
+			glShaderSource(shaderID, 1, &sourceCStr, nullptr);
+			glCompileShader(shaderID);
+
+			GLint isCompiled;
+			glGetShaderiv(shaderID, GL_COMPILE_STATUS, &isCompiled);
+			if (isCompiled == GL_FALSE)
+			{
+				GLint maxLength;
+				glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &maxLength);
+
+				std::vector<GLchar> infoLog(maxLength);
+				glGetShaderInfoLog(shaderID, maxLength, &maxLength, infoLog.data());
+				HZ_CORE_ERROR("Shader compilation failed ({0}, {1}):\n{2}", m_FilePath, Utils::GLShaderStageToString(stage), infoLog.data());
+			}
+
+			glAttachShader(program, shaderID);
+		}
+
+		LinkProgram(program, shaderIDs);
+	}
+
+	void OpenGLShader::LinkProgram(uint32_t program, const std::vector<uint32_t>& shaderIDs)
+	{
 		glLinkProgram(program);
 
 		GLint isLinked;
@@ -57,6 +57,9 @@ namespace Hazel {
 		void CompileOrGetVulkanBinaries(const std::unordered_map<GLenum, std::string>& shaderSources);
 		void CompileOrGetOpenGLBinaries();
 		void CreateProgram();
+		/** 不经过 SPIR-V，直接用 glShaderSource 编译 GLSL，用于 SPIR-V 不支持的扩展 */
+		void CompileFromSource(const std::unordered_map<GLenum, std::string>& shaderSources);
+		void LinkProgram(uint32_t program, const std::vector<uint32_t>& shaderIDs);
 		void Reflect(GLenum stage, const std::vector<uint32_t>& shaderData);
 
 	private:
@@ -1,5 +1,6 @@
 #include "hzpch.h"
 #include "Platform/OpenGL/OpenGLTexture.h"
+#include "Platform/OpenGL/OpenGLBindlessTexture.h"
 
 #include <stb_image.h>
 
@@ -7,6 +8,23 @@
 
 namespace Hazel {
 
+	/** RGBA 数据中是否有 alpha < 255 的像素，RGB 数据总是不透明 */
+	static bool HasTransparentPixels(const void* data, size_t pixelCount, GLenum dataFormat)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		if (dataFormat != GL_RGBA)
+			return false;
+
+		const uint8_t* pixels = (const uint8_t*)data;
+		for (size_t i = 0; i < pixelCount; i++)
+		{
+			if (pixels[i * 4 + 3] != 0xff)
+				return true;
+		}
+		return false;
+	}
+
 	OpenGLTexture2D::OpenGLTexture2D(uint32_t width, uint32_t height)
 		: m_Width(width), m_Height(height)
 	{
@@ -14,6 +32,7 @@ namespace Hazel {
 
 		m_InternalFormat = GL_RGBA8;
 		m_DataFormat = GL_RGBA;
+		m_IsLoaded = true;
 
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
 		glTextureStorage2D(m_RendererID, 1, m_InternalFormat, m_Width, m_Height);
@@ -97,6 +116,9 @@ namespace Hazel {
 			// 将图像数据上传到显存中
 			glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, dataFormat, GL_UNSIGNED_BYTE, data);
 
+			// 数据还在内存中时检查 alpha，之后不需要再读回
+			m_HasTransparency = HasTransparentPixels(data, (size_t)m_Width * m_Height, dataFormat);
+
 			// 释放 CPU 中的图像数据内存
 			stbi_image_free(data);
 		}
@@ -106,9 +128,22 @@ namespace Hazel {
 	{
 		HZ_PROFILE_FUNCTION();
 
+		if (m_BindlessHandle)
+			OpenGLBindlessTexture::MakeNonResident(m_BindlessHandle);
+
 		glDeleteTextures(1, &m_RendererID);
 	}
 
+	TextureFormat OpenGLTexture2D::GetFormat() const
+	{
+		switch (m_InternalFormat)
+		{
+			case GL_RGB8:  return TextureFormat::RGB8;
+			case GL_RGBA8: return TextureFormat::RGBA8;
+		}
+		return TextureFormat::None;
+	}
+
 	void OpenGLTexture2D::SetData(void* data, uint32_t size)
 	{
 		HZ_PROFILE_FUNCTION();
@@ -116,6 +151,28 @@ namespace Hazel {
 		uint32_t bpp = m_DataFormat == GL_RGBA ? 4 : 3;
 		HZ_CORE_ASSERT(size == m_Width * m_Height * bpp, "Data must be entire texture!");
 		glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, data);
+
+		m_HasTransparency = HasTransparentPixels(data, (size_t)m_Width * m_Height, m_DataFormat);
+	}
+
+	void OpenGLTexture2D::SetData(void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		HZ_CORE_ASSERT(x + width <= m_Width && y + height <= m_Height, "Region out of bounds!");
+		glTextureSubImage2D(m_RendererID, 0, x, y, width, height, m_DataFormat, GL_UNSIGNED_BYTE, data);
+
+		m_HasTransparency |= HasTransparentPixels(data, (size_t)width * height, m_DataFormat);
+	}
+
+	void OpenGLTexture2D::GetData(void* data, uint32_t size) const
+	{
+		HZ_PROFILE_FUNCTION();
+
+		HZ_CORE_ASSERT(size == m_Width * m_Height * 4, "Data must be entire texture!");
+
+		// 会等待之前所有写入该纹理的命令完成
+		glGetTextureImage(m_RendererID, 0, GL_RGBA, GL_UNSIGNED_BYTE, size, data);
 	}
 
 	void OpenGLTexture2D::Bind(uint32_t slot) const
@@ -124,4 +181,129 @@ namespace Hazel {
 
 		glBindTextureUnit(slot, m_RendererID);
 	}
-}
+
+	uint64_t OpenGLTexture2D::GetBindlessHandle() const
+	{
+		// 加载失败的纹理没有纹理对象，返回 0 由调用方替换成其它纹理
+		if (!m_BindlessHandle && m_RendererID)
+			m_BindlessHandle = OpenGLBindlessTexture::MakeResident(m_RendererID);
+
+		return m_BindlessHandle;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////
+	// Texture2DArray ///////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+
+	OpenGLTexture2DArray::OpenGLTexture2DArray(uint32_t width, uint32_t height, uint32_t layerCount, TextureFormat format)
+		: m_Width(width), m_Height(height), m_LayerCount(layerCount), m_Format(format)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		switch (format)
+		{
+			case TextureFormat::RGB8:  m_InternalFormat = GL_RGB8;  m_DataFormat = GL_RGB;  break;
+			case TextureFormat::RGBA8: m_InternalFormat = GL_RGBA8; m_DataFormat = GL_RGBA; break;
+			default: HZ_CORE_ASSERT(false, "Format not supported!"); m_InternalFormat = GL_RGBA8; m_DataFormat = GL_RGBA; break;
+		}
+
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_RendererID);
+		glTextureStorage3D(m_RendererID, 1, m_InternalFormat, m_Width, m_Height, m_LayerCount);
+
+		// 与 OpenGLTexture2D 相同的采样参数，每一层的效果与单独的纹理一致
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	}
+
+	OpenGLTexture2DArray::~OpenGLTexture2DArray()
+	{
+		HZ_PROFILE_FUNCTION();
+
+		if (m_BindlessHandle)
+			OpenGLBindlessTexture::MakeNonResident(m_BindlessHandle);
+
+		glDeleteTextures(1, &m_RendererID);
+	}
+
+	void OpenGLTexture2DArray::SetData(void* data, uint32_t size)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		uint32_t bpp = m_DataFormat == GL_RGBA ? 4 : 3;
+		HZ_CORE_ASSERT(size == m_Width * m_Height * m_LayerCount * bpp, "Data must be entire texture array!");
+		glTextureSubImage3D(m_RendererID, 0, 0, 0, 0, m_Width, m_Height, m_LayerCount, m_DataFormat, GL_UNSIGNED_BYTE, data);
+
+		m_HasTransparency = HasTransparentPixels(data, (size_t)m_Width * m_Height * m_LayerCount, m_DataFormat);
+	}
+
+	void OpenGLTexture2DArray::SetData(void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		SetLayerData(0, data, x, y, width, height);
+	}
+
+	void OpenGLTexture2DArray::SetLayerData(uint32_t layer, void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		HZ_CORE_ASSERT(layer < m_LayerCount, "Layer out of range!");
+		HZ_CORE_ASSERT(x + width <= m_Width && y + height <= m_Height, "Region out of bounds!");
+		glTextureSubImage3D(m_RendererID, 0, x, y, layer, width, height, 1, m_DataFormat, GL_UNSIGNED_BYTE, data);
+
+		m_HasTransparency |= HasTransparentPixels(data, (size_t)width * height, m_DataFormat);
+	}
+
+	void OpenGLTexture2DArray::GetData(void* data, uint32_t size) const
+	{
+		HZ_PROFILE_FUNCTION();
+
+		HZ_CORE_ASSERT(size == m_Width * m_Height * m_LayerCount * 4, "Data must be entire texture array!");
+		glGetTextureImage(m_RendererID, 0, GL_RGBA, GL_UNSIGNED_BYTE, size, data);
+	}
+
+	void OpenGLTexture2DArray::CopyLayer(uint32_t layer, const Ref<Texture2D>& source)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		HZ_CORE_ASSERT(layer < m_LayerCount, "Layer out of range!");
+		HZ_CORE_ASSERT(source->GetWidth() == m_Width && source->GetHeight() == m_Height && source->GetFormat() == m_Format, "Source texture does not match the texture array!");
+
+		// 显存内复制，不需要读回 CPU
+		glCopyImageSubData(source->GetRendererID(), GL_TEXTURE_2D, 0, 0, 0, 0,
+			m_RendererID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer,
+			m_Width, m_Height, 1);
+
+		m_HasTransparency |= source->HasTransparency();
+	}
+
+	void OpenGLTexture2DArray::CopyLayers(const Ref<Texture2DArray>& source, uint32_t layerCount)
+	{
+		HZ_PROFILE_FUNCTION();
+
+		HZ_CORE_ASSERT(layerCount <= m_LayerCount && layerCount <= source->GetLayerCount(), "Layer out of range!");
+		HZ_CORE_ASSERT(source->GetWidth() == m_Width && source->GetHeight() == m_Height && source->GetFormat() == m_Format, "Source texture array does not match the texture array!");
+
+		glCopyImageSubData(source->GetRendererID(), GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+			m_RendererID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+			m_Width, m_Height, layerCount);
+
+		m_HasTransparency |= source->HasTransparency();
+	}
+
+	void OpenGLTexture2DArray::Bind(uint32_t slot) const
+	{
+		HZ_PROFILE_FUNCTION();
+
+		glBindTextureUnit(slot, m_RendererID);
+	}
+
+	uint64_t OpenGLTexture2DArray::GetBindlessHandle() const
+	{
+		if (!m_BindlessHandle)
+			m_BindlessHandle = OpenGLBindlessTexture::MakeResident(m_RendererID);
+
+		return m_BindlessHandle;
+	}
+}
\ No newline at end of file
@@ -16,12 +16,21 @@ namespace Hazel {
 		virtual uint32_t GetWidth() const override { return m_Width;  }
 		virtual uint32_t GetHeight() const override { return m_Height; }
 		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+		virtual TextureFormat GetFormat() const override;
+
+		virtual const std::string& GetPath() const override { return m_Path; }
 
 		virtual void SetData(void* data, uint32_t size);
+		virtual void SetData(void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+		virtual void GetData(void* data, uint32_t size) const override;
 
 		virtual void Bind(uint32_t slot = 0) const override;
 
+		virtual uint64_t GetBindlessHandle() const override;
+
 		virtual bool IsLoaded() const override { return m_IsLoaded; }
+		/** 只写入部分区域时与原有结果合并，图集页只要有一块半透明就按半透明处理 */
+		virtual bool HasTransparency() const override { return m_HasTransparency; }
 
 		virtual bool operator==(const Texture& other) const override
 		{
@@ -31,9 +40,60 @@ namespace Hazel {
 	private:
 		std::string m_Path;
 		bool m_IsLoaded = false;
-		uint32_t m_Width, m_Height;
-		uint32_t m_RendererID;
+		bool m_HasTransparency = false;
+		uint32_t m_Width = 0, m_Height = 0;
+		uint32_t m_RendererID = 0;
+		GLenum m_InternalFormat, m_DataFormat;
+
+		mutable uint64_t m_BindlessHandle = 0;
+	};
+
+	/**
+	* 基于 glTextureStorage3D 的不可变纹理数组，层之间用 glCopyImageSubData 在显存中直接复制
+	*/
+	class OpenGLTexture2DArray : public Texture2DArray
+	{
+	public:
+		OpenGLTexture2DArray(uint32_t width, uint32_t height, uint32_t layerCount, TextureFormat format);
+		virtual ~OpenGLTexture2DArray();
+
+		virtual uint32_t GetWidth() const override { return m_Width; }
+		virtual uint32_t GetHeight() const override { return m_Height; }
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+		virtual TextureFormat GetFormat() const override { return m_Format; }
+		virtual uint32_t GetLayerCount() const override { return m_LayerCount; }
+
+		/** 纹理数组没有对应的文件 */
+		virtual const std::string& GetPath() const override { return m_Path; }
+
+		virtual void SetData(void* data, uint32_t size) override;
+		virtual void SetData(void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+		virtual void GetData(void* data, uint32_t size) const override;
+
+		virtual void SetLayerData(uint32_t layer, void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+		virtual void CopyLayer(uint32_t layer, const Ref<Texture2D>& source) override;
+		virtual void CopyLayers(const Ref<Texture2DArray>& source, uint32_t layerCount) override;
+
+		virtual void Bind(uint32_t slot = 0) const override;
+
+		virtual uint64_t GetBindlessHandle() const override;
+
+		virtual bool IsLoaded() const override { return true; }
+		virtual bool HasTransparency() const override { return m_HasTransparency; }
+
+		virtual bool operator==(const Texture& other) const override
+		{
+			return m_RendererID == other.GetRendererID();
+		}
+	private:
+		std::string m_Path;
+		uint32_t m_Width, m_Height, m_LayerCount;
+		TextureFormat m_Format;
+		bool m_HasTransparency = false;
+		uint32_t m_RendererID = 0;
 		GLenum m_InternalFormat, m_DataFormat;
+
+		mutable uint64_t m_BindlessHandle = 0;
 	};
 
-}
+}
\ No newline at end of file
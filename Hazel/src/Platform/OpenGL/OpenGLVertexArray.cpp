@@ -20,6 +20,11 @@ namespace Hazel {
 			case Hazel::ShaderDataType::Int3:     return GL_INT;
 			case Hazel::ShaderDataType::Int4:     return GL_INT;
 			case Hazel::ShaderDataType::Bool:     return GL_BOOL;
+			case Hazel::ShaderDataType::Half:     return GL_HALF_FLOAT;
+			case Hazel::ShaderDataType::Half2:    return GL_HALF_FLOAT;
+			case Hazel::ShaderDataType::Half4:    return GL_HALF_FLOAT;
+			case Hazel::ShaderDataType::UInt:     return GL_UNSIGNED_INT;
+			case Hazel::ShaderDataType::UByte4:   return GL_UNSIGNED_BYTE;
 		}
 
 		HZ_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -64,6 +69,9 @@ namespace Hazel {
 		vertexBuffer->Bind();
 
 		const auto& layout = vertexBuffer->GetLayout();
+
+		// 实例属性每个实例只前进一次
+		const GLuint divisor = layout.GetInputRate() == VertexInputRate::Instance ? 1 : 0;
 		for (const auto& element : layout)
 		{
 
@@ -73,6 +81,10 @@ namespace Hazel {
 			case ShaderDataType::Float2:
 			case ShaderDataType::Float3:
 			case ShaderDataType::Float4:
+			case ShaderDataType::Half:
+			case ShaderDataType::Half2:
+			case ShaderDataType::Half4:
+			case ShaderDataType::UByte4:
 			{
 				glEnableVertexAttribArray(m_VertexBufferIndex);
 
@@ -91,6 +103,7 @@ namespace Hazel {
 					element.Normalized ? GL_TRUE : GL_FALSE,
 					layout.GetStride(),
 					(const void*)element.Offset);
+				glVertexAttribDivisor(m_VertexBufferIndex, divisor);
 				m_VertexBufferIndex++;
 				break;
 			}
@@ -98,6 +111,7 @@ namespace Hazel {
 			case ShaderDataType::Int2:
 			case ShaderDataType::Int3:
 			case ShaderDataType::Int4:
+			case ShaderDataType::UInt:
 			case ShaderDataType::Bool:
 			{
 				// 设置顶点属性指针(顶点属性 0（索引 0）)
@@ -107,6 +121,7 @@ namespace Hazel {
 					ShaderDataTypeToOpenGLBaseType(element.Type),
 					layout.GetStride(),
 					(const void*)element.Offset);
+				glVertexAttribDivisor(m_VertexBufferIndex, divisor);
 				m_VertexBufferIndex++;
 				break;
 			}
@@ -6,16 +6,20 @@
 #type vertex
 #version 450 core
 
-layout(location = 0) in vec3 a_WorldPosition;
-layout(location = 1) in vec3 a_LocalPosition;
-layout(location = 2) in vec4 a_Color;
-layout(location = 3) in float a_Thickness;
-layout(location = 4) in float a_Fade;
-layout(location = 5) in int a_EntityID;
+// 每个实例一个圆，角 = Translation + (±0.5) * AxisX + (±0.5) * AxisY
+// 颜色为 RGBA8 归一化，Thickness / Fade 为半精度，由顶点属性格式自动转换
+layout(location = 0) in vec3 a_AxisX;
+layout(location = 1) in int a_EntityID;
+layout(location = 2) in vec3 a_AxisY;
+layout(location = 3) in vec4 a_Color;
+layout(location = 4) in vec3 a_Translation;
+layout(location = 5) in float a_Thickness;
+layout(location = 6) in float a_Fade;
 
 layout(std140, binding = 0) uniform Camera
 {
 	mat4 u_ViewProjection;
+	vec2 u_ViewportSize;
 };
 
 struct VertexOutput
@@ -29,16 +33,25 @@ struct VertexOutput
 layout (location = 0) out VertexOutput Output;
 layout (location = 4) out flat int v_EntityID;
 
+// 两个三角形 (0, 1, 2) (2, 3, 0) 对应的单位 Quad 角
+const vec2 c_Corners[6] = vec2[](
+	vec2(-0.5, -0.5), vec2( 0.5, -0.5), vec2( 0.5,  0.5),
+	vec2( 0.5,  0.5), vec2(-0.5,  0.5), vec2(-0.5, -0.5)
+);
+
 void main()
 {
-	Output.LocalPosition = a_LocalPosition;
+	vec2 corner = c_Corners[gl_VertexIndex];
+	vec3 position = a_Translation + corner.x * a_AxisX + corner.y * a_AxisY;
+
+	Output.LocalPosition = vec3(corner * 2.0, 0.0);
 	Output.Color = a_Color;
 	Output.Thickness = a_Thickness;
 	Output.Fade = a_Fade;
 
 	v_EntityID = a_EntityID;
 
-	gl_Position = u_ViewProjection * vec4(a_WorldPosition, 1.0);
+	gl_Position = u_ViewProjection * vec4(position, 1.0);
 }
 
 #type fragment
@@ -6,13 +6,17 @@
 #type vertex
 #version 450 core
 
-layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec4 a_Color;
-layout(location = 2) in int a_EntityID;
+// 每条线段一个实例，在屏幕空间展开成宽 a_Width 像素的矩形，两端各延长半个线宽作为方形端点
+layout(location = 0) in vec3 a_P0;
+layout(location = 1) in int a_EntityID;
+layout(location = 2) in vec3 a_P1;
+layout(location = 3) in vec4 a_Color;
+layout(location = 4) in float a_Width;
 
 layout(std140, binding = 0) uniform Camera
 {
 	mat4 u_ViewProjection;
+	vec2 u_ViewportSize;
 };
 
 struct VertexOutput
@@ -23,12 +27,40 @@ struct VertexOutput
 layout (location = 0) out VertexOutput Output;
 layout (location = 1) out flat int v_EntityID;
 
+// 两个三角形对应的角：x = 0 为 P0 端，1 为 P1 端；y 为法线方向的一侧
+const vec2 c_Corners[6] = vec2[](
+	vec2(0.0, -1.0), vec2(1.0, -1.0), vec2(1.0,  1.0),
+	vec2(1.0,  1.0), vec2(0.0,  1.0), vec2(0.0, -1.0)
+);
+
 void main()
 {
+	vec2 corner = c_Corners[gl_VertexIndex];
+
+	vec4 clip0 = u_ViewProjection * vec4(a_P0, 1.0);
+	vec4 clip1 = u_ViewProjection * vec4(a_P1, 1.0);
+
+	// 在像素空间计算线段方向，线宽与相机缩放无关
+	vec2 halfViewport = 0.5 * u_ViewportSize;
+	vec2 screen0 = clip0.xy / clip0.w * halfViewport;
+	vec2 screen1 = clip1.xy / clip1.w * halfViewport;
+
+	vec2 direction = screen1 - screen0;
+	float segmentLength = length(direction);
+	direction = segmentLength > 0.0001 ? direction / segmentLength : vec2(1.0, 0.0);
+	vec2 normal = vec2(-direction.y, direction.x);
+
+	// 不足一个像素的线段会在光栅化时断断续续，最少保留一个像素宽
+	float halfWidth = 0.5 * max(a_Width, 1.0);
+	vec2 offset = (normal * corner.y + direction * (corner.x * 2.0 - 1.0)) * halfWidth;
+
+	vec4 position = corner.x == 0.0 ? clip0 : clip1;
+	position.xy += offset / halfViewport * position.w;
+
 	Output.Color = a_Color;
 	v_EntityID = a_EntityID;
 
-	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+	gl_Position = position;
 }
 
 #type fragment
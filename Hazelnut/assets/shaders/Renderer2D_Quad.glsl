@@ -3,16 +3,21 @@
 #type vertex
 #version 450 core
 
-layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec4 a_Color;
-layout(location = 2) in vec2 a_TexCoord;
-layout(location = 3) in float a_TexIndex;
-layout(location = 4) in float a_TilingFactor;
-layout(location = 5) in int a_EntityID;
+// 每个实例一个 Quad，角 = Translation + (±0.5) * AxisX + (±0.5) * AxisY
+// 颜色为 RGBA8 归一化，纹理坐标与平铺系数为半精度，由顶点属性格式自动转换
+layout(location = 0) in vec3 a_AxisX;
+layout(location = 1) in int a_EntityID;
+layout(location = 2) in vec3 a_AxisY;
+layout(location = 3) in vec4 a_Color;
+layout(location = 4) in vec3 a_Translation;
+layout(location = 5) in uint a_TexIndex; // 低 16 位为纹理槽，16 ~ 27 位为纹理数组层，31 位为纹理数组标志
+layout(location = 6) in vec4 a_TexRect;
+layout(location = 7) in float a_TilingFactor;
 
 layout(std140, binding = 0) uniform Camera
 {
 	mat4 u_ViewProjection;
+	vec2 u_ViewportSize;
 };
 
 struct VertexOutput
@@ -23,18 +28,29 @@ struct VertexOutput
 };
 
 layout (location = 0) out VertexOutput Output;
-layout (location = 3) out flat float v_TexIndex;
+layout (location = 3) out flat int v_TexIndex;
 layout (location = 4) out flat int v_EntityID;
+layout (location = 5) out flat float v_TexLayer;
+
+// 两个三角形 (0, 1, 2) (2, 3, 0) 对应的单位 Quad 角
+const vec2 c_Corners[6] = vec2[](
+	vec2(-0.5, -0.5), vec2( 0.5, -0.5), vec2( 0.5,  0.5),
+	vec2( 0.5,  0.5), vec2(-0.5,  0.5), vec2(-0.5, -0.5)
+);
 
 void main()
 {
+	vec2 corner = c_Corners[gl_VertexIndex];
+	vec3 position = a_Translation + corner.x * a_AxisX + corner.y * a_AxisY;
+
 	Output.Color = a_Color;
-	Output.TexCoord = a_TexCoord;
+	Output.TexCoord = mix(a_TexRect.xy, a_TexRect.zw, corner + 0.5);
 	Output.TilingFactor = a_TilingFactor;
-	v_TexIndex = a_TexIndex;
+	v_TexIndex = int(a_TexIndex & 0xffffu);
+	v_TexLayer = float((a_TexIndex >> 16) & 0xfffu);
 	v_EntityID = a_EntityID;
 
-	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+	gl_Position = u_ViewProjection * vec4(position, 1.0);
 }
 
 #type fragment
@@ -51,16 +67,19 @@ struct VertexOutput
 };
 
 layout (location = 0) in VertexOutput Input;
-layout (location = 3) in flat float v_TexIndex;
+layout (location = 3) in flat int v_TexIndex;
 layout (location = 4) in flat int v_EntityID;
+layout (location = 5) in flat float v_TexLayer;
 
-layout (binding = 0) uniform sampler2D u_Textures[32];
+// 0 ~ 23 为普通纹理，24 ~ 31 为同尺寸精灵合并成的纹理数组
+layout (binding = 0) uniform sampler2D u_Textures[24];
+layout (binding = 24) uniform sampler2DArray u_TextureArrays[8];
 
 void main()
 {
 	vec4 texColor = Input.Color;
 
-	switch(int(v_TexIndex))
+	switch(v_TexIndex)
 	{
 		case  0: texColor *= texture(u_Textures[ 0], Input.TexCoord * Input.TilingFactor); break;
 		case  1: texColor *= texture(u_Textures[ 1], Input.TexCoord * Input.TilingFactor); break;
@@ -86,14 +105,14 @@ void main()
 		case 21: texColor *= texture(u_Textures[21], Input.TexCoord * Input.TilingFactor); break;
 		case 22: texColor *= texture(u_Textures[22], Input.TexCoord * Input.TilingFactor); break;
 		case 23: texColor *= texture(u_Textures[23], Input.TexCoord * Input.TilingFactor); break;
-		case 24: texColor *= texture(u_Textures[24], Input.TexCoord * Input.TilingFactor); break;
-		case 25: texColor *= texture(u_Textures[25], Input.TexCoord * Input.TilingFactor); break;
-		case 26: texColor *= texture(u_Textures[26], Input.TexCoord * Input.TilingFactor); break;
-		case 27: texColor *= texture(u_Textures[27], Input.TexCoord * Input.TilingFactor); break;
-		case 28: texColor *= texture(u_Textures[28], Input.TexCoord * Input.TilingFactor); break;
-		case 29: texColor *= texture(u_Textures[29], Input.TexCoord * Input.TilingFactor); break;
-		case 30: texColor *= texture(u_Textures[30], Input.TexCoord * Input.TilingFactor); break;
-		case 31: texColor *= texture(u_Textures[31], Input.TexCoord * Input.TilingFactor); break;
+		case 24: texColor *= texture(u_TextureArrays[0], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 25: texColor *= texture(u_TextureArrays[1], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 26: texColor *= texture(u_TextureArrays[2], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 27: texColor *= texture(u_TextureArrays[3], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 28: texColor *= texture(u_TextureArrays[4], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 29: texColor *= texture(u_TextureArrays[5], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 30: texColor *= texture(u_TextureArrays[6], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
+		case 31: texColor *= texture(u_TextureArrays[7], vec3(Input.TexCoord * Input.TilingFactor, v_TexLayer)); break;
 	}
 
 	// 如果最终的纹理颜色的 alpha 值为 0，则丢弃该片元（fragment），也就是说，它不会被写入颜色缓冲或深度缓冲。
@@ -0,0 +1,88 @@
+// Basic Texture Shader (bindless)
+// 不经过 SPIR-V，由驱动直接编译：GLSL 中使用 gl_VertexID 而不是 gl_VertexIndex
+
+#type vertex
+#version 450 core
+
+// 与 Renderer2D_Quad.glsl 相同的实例布局
+layout(location = 0) in vec3 a_AxisX;
+layout(location = 1) in int a_EntityID;
+layout(location = 2) in vec3 a_AxisY;
+layout(location = 3) in vec4 a_Color;
+layout(location = 4) in vec3 a_Translation;
+layout(location = 5) in uint a_TexIndex; // 低 16 位为纹理句柄表的下标，高 16 位为标志位
+layout(location = 6) in vec4 a_TexRect;
+layout(location = 7) in float a_TilingFactor;
+
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjection;
+	vec2 u_ViewportSize;
+};
+
+struct VertexOutput
+{
+	vec4 Color;
+	vec2 TexCoord;
+	float TilingFactor;
+};
+
+layout (location = 0) out VertexOutput Output;
+layout (location = 3) out flat int v_TexIndex;
+layout (location = 4) out flat int v_EntityID;
+
+const vec2 c_Corners[6] = vec2[](
+	vec2(-0.5, -0.5), vec2( 0.5, -0.5), vec2( 0.5,  0.5),
+	vec2( 0.5,  0.5), vec2(-0.5,  0.5), vec2(-0.5, -0.5)
+);
+
+void main()
+{
+	vec2 corner = c_Corners[gl_VertexID];
+	vec3 position = a_Translation + corner.x * a_AxisX + corner.y * a_AxisY;
+
+	Output.Color = a_Color;
+	Output.TexCoord = mix(a_TexRect.xy, a_TexRect.zw, corner + 0.5);
+	Output.TilingFactor = a_TilingFactor;
+	v_TexIndex = int(a_TexIndex & 0xffffu);
+	v_EntityID = a_EntityID;
+
+	gl_Position = u_ViewProjection * vec4(position, 1.0);
+}
+
+#type fragment
+#version 450 core
+#extension GL_ARB_bindless_texture : require
+
+layout(location = 0) out vec4 o_Color;
+layout(location = 1) out int o_EntityID;
+
+struct VertexOutput
+{
+	vec4 Color;
+	vec2 TexCoord;
+	float TilingFactor;
+};
+
+layout (location = 0) in VertexOutput Input;
+layout (location = 3) in flat int v_TexIndex;
+layout (location = 4) in flat int v_EntityID;
+
+// 当前批次引用的纹理句柄，下标 0 为白色纹理
+layout(std430, binding = 1) readonly buffer TextureHandles
+{
+	uvec2 u_TextureHandles[];
+};
+
+void main()
+{
+	sampler2D textureSampler = sampler2D(u_TextureHandles[v_TexIndex]);
+	vec4 texColor = Input.Color * texture(textureSampler, Input.TexCoord * Input.TilingFactor);
+
+	// 如果最终的纹理颜色的 alpha 值为 0，则丢弃该片元（fragment），也就是说，它不会被写入颜色缓冲或深度缓冲。
+	if (texColor.a == 0.0)
+		discard;
+
+	o_Color = texColor;
+	o_EntityID = v_EntityID;
+}
@@ -110,6 +110,16 @@ namespace Hazel {
 			}
 		}
 
+		if (m_SceneState != SceneState::Edit)
+		{
+			m_SnapshotTimer += ts;
+			if (m_SnapshotTimer >= m_SnapshotInterval)
+			{
+				m_SnapshotTimer = 0.0f;
+				CaptureSnapshot();
+			}
+		}
+
 		// 获取鼠标下的像素数据，后期可以用来获取识别实体
 		auto [mx, my] = ImGui::GetMousePos();
 		mx -= m_ViewportBounds[0].x;
@@ -223,14 +233,53 @@ namespace Hazel {
 		auto stats = Renderer2D::GetStats();
 		ImGui::Text("Renderer2D Stats:");
 		ImGui::Text("Draw Calls: %d", stats.DrawCalls);
+		ImGui::Text("Batches: %d", stats.Batches);
 		ImGui::Text("Quads: %d", stats.QuadCount);
 		ImGui::Text("Vertices: %d", stats.GetTotalVertexCount());
-		ImGui::Text("Indices: %d", stats.GetTotalIndexCount());
+		ImGui::Text("Instances: %d", stats.GetTotalInstanceCount());
+		ImGui::Text("Sorted Commands: %d", stats.SortedCommands);
+		ImGui::Text("Batch Breaks Avoided: %d", stats.BatchBreaksAvoided);
+		ImGui::Text("Opaque Quads: %d", stats.OpaqueQuadCount);
+		ImGui::Text("Drawn Entities: %d", stats.DrawnCount);
+		ImGui::Text("Culled Entities: %d", stats.CulledCount);
+
+		if (m_SceneState == SceneState::Play)
+		{
+			ImGui::Separator();
+			ImGui::Text("Runtime Systems:");
+			for (const auto& system : m_ActiveScene->GetRuntimeSystems().GetSystems())
+				ImGui::Text("%s: %.3f ms", system->Name.c_str(), system->Milliseconds);
+		}
 
 		ImGui::End();
 
 		ImGui::Begin("Settings");
 		ImGui::Checkbox("Show physics colliders", &m_ShowPhysicsColliders);
+
+		// 物理设置属于场景，编辑模式下修改的是会被保存的编辑器场景
+		auto& physics = m_ActiveScene->GetPhysicsSettings();
+		float tickRate = 1.0f / physics.FixedTimestep;
+		if (ImGui::DragFloat("Physics Tick Rate", &tickRate, 1.0f, 10.0f, 1000.0f, "%.0f Hz"))
+			physics.FixedTimestep = 1.0f / std::max(tickRate, 10.0f);
+		int maxSubsteps = (int)physics.MaxSubsteps;
+		if (ImGui::DragInt("Max Substeps", &maxSubsteps, 0.1f, 1, 64))
+			physics.MaxSubsteps = (uint32_t)std::max(maxSubsteps, 1);
+		ImGui::DragInt("Velocity Iterations", &physics.VelocityIterations, 0.1f, 1, 32);
+		ImGui::DragInt("Position Iterations", &physics.PositionIterations, 0.1f, 1, 32);
+		ImGui::Checkbox("Interpolate Physics", &physics.Interpolate);
+
+		if (m_SceneState != SceneState::Edit && !m_Snapshots.empty())
+		{
+			ImGui::Separator();
+			const auto& latest = m_Snapshots.back();
+			ImGui::Text("Snapshots: %d", (int)m_Snapshots.size());
+			ImGui::Text("Latest: %u / %u pages shared, %.2f MB new", latest->GetSharedPageCount(), latest->GetPageCount(), latest->GetOwnedBytes() / (1024.0 * 1024.0));
+			ImGui::DragFloat("Snapshot Interval", &m_SnapshotInterval, 0.1f, 0.1f, 10.0f, "%.1f s");
+			m_RewindIndex = std::min(m_RewindIndex, (int)m_Snapshots.size() - 1);
+			ImGui::SliderInt("Rewind To", &m_RewindIndex, 0, (int)m_Snapshots.size() - 1);
+			if (ImGui::Button("Rewind"))
+				OnSceneRewind((size_t)m_RewindIndex);
+		}
 		ImGui::End();
 
 		ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2{ 0, 0 });
@@ -286,8 +335,11 @@ namespace Hazel {
 			glm::mat4 cameraView = m_EditorCamera.GetViewMatrix();
 
 			// Entity transform
+			// 有父节点时 TRS 是局部变换，Gizmo 在世界空间中操作
 			auto& tc = selectedEntity.GetComponent<TransformComponent>();
-			glm::mat4 transform = tc.GetTransform();
+			Entity parent = selectedEntity.GetParent();
+			glm::mat4 parentTransform = parent ? parent.GetComponent<TransformComponent>().WorldTransform : glm::mat4(1.0f);
+			glm::mat4 transform = parentTransform * tc.GetTransform();
 
 			// Snapping
 			bool snap = Input::IsKeyPressed(Key::LeftControl);
@@ -305,12 +357,15 @@ namespace Hazel {
 			if (ImGuizmo::IsUsing())
 			{
 				glm::vec3 translation, rotation, scale;
-				Math::DecomposeTransform(transform, translation, rotation, scale);
+				Math::DecomposeTransform(glm::inverse(parentTransform) * transform, translation, rotation, scale);
 
 				glm::vec3 deltaRotation = rotation - tc.Rotation;
-				tc.Translation = translation;
-				tc.Rotation += deltaRotation;
-				tc.Scale = scale;
+				selectedEntity.PatchComponent<TransformComponent>([&](auto& component)
+				{
+					component.Translation = translation;
+					component.Rotation += deltaRotation;
+					component.Scale = scale;
+				});
 			}
 		}
 
@@ -417,7 +472,7 @@ namespace Hazel {
 			if (!camera)
 				return;
 
-			Renderer2D::BeginScene(camera.GetComponent<CameraComponent>().Camera, camera.GetComponent<TransformComponent>().GetTransform());
+			Renderer2D::BeginScene(camera.GetComponent<CameraComponent>().Camera, camera.GetComponent<TransformComponent>().WorldTransform);
 		}
 		else
 		{
@@ -433,11 +488,15 @@ namespace Hazel {
 				{
 					auto [tc, bc2d] = view.get<TransformComponent, BoxCollider2DComponent>(entity);
 
-					glm::vec3 translation = tc.Translation + glm::vec3(bc2d.Offset, 0.001f);
-					glm::vec3 scale = tc.Scale * glm::vec3(bc2d.Size * 2.0f, 1.0f);
+					// 与 Scene::OnPhysics2DStart 相同，碰撞体按世界矩阵分解出的位置、角度与缩放创建
+					glm::vec3 worldTranslation, worldRotation, worldScale;
+					Math::DecomposeTransform(tc.WorldTransform, worldTranslation, worldRotation, worldScale);
+
+					glm::vec3 translation = worldTranslation + glm::vec3(bc2d.Offset, 0.001f);
+					glm::vec3 scale = worldScale * glm::vec3(bc2d.Size * 2.0f, 1.0f);
 
 					glm::mat4 transform = glm::translate(glm::mat4(1.0f), translation)
-						* glm::rotate(glm::mat4(1.0f), tc.Rotation.z, glm::vec3(0.0f, 0.0f, 1.0f))
+						* glm::rotate(glm::mat4(1.0f), worldRotation.z, glm::vec3(0.0f, 0.0f, 1.0f))
 						* glm::scale(glm::mat4(1.0f), scale);
 
 					Renderer2D::DrawRect(transform, glm::vec4(0, 1, 0, 1));
@@ -451,8 +510,11 @@ namespace Hazel {
 				{
 					auto [tc, cc2d] = view.get<TransformComponent, CircleCollider2DComponent>(entity);
 
-					glm::vec3 translation = tc.Translation + glm::vec3(cc2d.Offset, 0.001f);
-					glm::vec3 scale = tc.Scale * glm::vec3(cc2d.Radius * 2.0f);
+					glm::vec3 worldTranslation, worldRotation, worldScale;
+					Math::DecomposeTransform(tc.WorldTransform, worldTranslation, worldRotation, worldScale);
+
+					glm::vec3 translation = worldTranslation + glm::vec3(cc2d.Offset, 0.001f);
+					glm::vec3 scale = worldScale * glm::vec3(cc2d.Radius * 2.0f);
 
 					glm::mat4 transform = glm::translate(glm::mat4(1.0f), translation)
 						* glm::scale(glm::mat4(1.0f), scale);
@@ -466,7 +528,7 @@ namespace Hazel {
 		if (Entity selectedEntity = m_SceneHierarchyPanel.GetSelectedEntity())
 		{
 			const TransformComponent& transform = selectedEntity.GetComponent<TransformComponent>();
-			Renderer2D::DrawRect(transform.GetTransform(), glm::vec4(1.0f, 0.5f, 0.0f, 1.0f));
+			Renderer2D::DrawRect(transform.WorldTransform, glm::vec4(1.0f, 0.5f, 0.0f, 1.0f));
 		}
 
 		Renderer2D::EndScene();
@@ -547,6 +609,9 @@ namespace Hazel {
 		m_ActiveScene->OnRuntimeStart();
 
 		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
+
+		m_Snapshots.clear();
+		CaptureSnapshot();
 	}
 
 	void EditorLayer::OnSceneSimulate()
@@ -560,6 +625,9 @@ namespace Hazel {
 		m_ActiveScene->OnSimulationStart();
 
 		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
+
+		m_Snapshots.clear();
+		CaptureSnapshot();
 	}
 
 	void EditorLayer::OnSceneStop()
@@ -576,6 +644,43 @@ namespace Hazel {
 		m_ActiveScene = m_EditorScene;
 
 		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
+
+		m_Snapshots.clear();
+	}
+
+	void EditorLayer::OnSceneRewind(size_t index)
+	{
+		HZ_CORE_ASSERT(m_SceneState == SceneState::Play || m_SceneState == SceneState::Simulate);
+		HZ_CORE_ASSERT(index < m_Snapshots.size());
+
+		if (m_SceneState == SceneState::Play)
+			m_ActiveScene->OnRuntimeStop();
+		else
+			m_ActiveScene->OnSimulationStop();
+
+		// 旧场景随之释放，悬停的实体在下一帧重新读取
+		m_HoveredEntity = {};
+		m_ActiveScene = m_Snapshots[index]->Restore();
+
+		if (m_SceneState == SceneState::Play)
+			m_ActiveScene->OnRuntimeStart();
+		else
+			m_ActiveScene->OnSimulationStart();
+
+		m_SceneHierarchyPanel.SetContext(m_ActiveScene);
+
+		m_Snapshots.resize(index + 1);
+		m_SnapshotTimer = 0.0f;
+	}
+
+	void EditorLayer::CaptureSnapshot()
+	{
+		Ref<SceneSnapshot> previous = m_Snapshots.empty() ? nullptr : m_Snapshots.back();
+		m_Snapshots.push_back(SceneSnapshot::Capture(m_ActiveScene, previous));
+		if ((int)m_Snapshots.size() > m_MaxSnapshots)
+			m_Snapshots.erase(m_Snapshots.begin());
+
+		m_SnapshotTimer = 0.0f;
 	}
 
 	void EditorLayer::OnDuplicateEntity()
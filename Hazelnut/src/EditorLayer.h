@@ -36,6 +36,9 @@ namespace Hazel {
 		void OnScenePlay();
 		void OnSceneSimulate();
 		void OnSceneStop();
+		/** 回到第 index 个快照，之后的快照被丢弃 */
+		void OnSceneRewind(size_t index);
+		void CaptureSnapshot();
 
 		void OnDuplicateEntity();
 
@@ -80,6 +83,13 @@ namespace Hazel {
 		};
 		SceneState m_SceneState = SceneState::Edit;
 
+		// 运行或模拟时定期捕获的快照，相邻快照共享没有变化的组件页
+		std::vector<Ref<SceneSnapshot>> m_Snapshots;
+		float m_SnapshotInterval = 1.0f;
+		float m_SnapshotTimer = 0.0f;
+		int m_MaxSnapshots = 30;
+		int m_RewindIndex = 0;
+
 		// Panels
 		SceneHierarchyPanel m_SceneHierarchyPanel;
 		ContentBrowserPanel m_ContentBrowserPanel;
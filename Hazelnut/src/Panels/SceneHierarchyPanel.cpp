@@ -38,10 +38,12 @@ namespace Hazel {
 
 		if (m_Context)
 		{
-			// 获取当前场景中所有注册过的 Entity
+			// 获取当前场景中所有注册过的 Entity，子节点在父节点下递归绘制
 			m_Context->m_Registry.each([&](auto entityID)
 				{
 					Entity entity{ entityID , m_Context.get() };
+					if (entity.GetParent())
+						return;
 
 					// 将 Entity 信息绘制在 Scene Hierarchy 面板上
 					DrawEntityNode(entity);
@@ -80,8 +82,18 @@ namespace Hazel {
 	{
 		auto& tag = entity.GetComponent<TagComponent>().Tag;
 		
+		// 绘制过程中可能拖放修改层级，先记下子节点
+		std::vector<entt::entity> children;
+		if (auto* relationship = m_Context->m_Registry.try_get<RelationshipComponent>(entity))
+		{
+			for (entt::entity child = relationship->FirstChild; child != entt::null; child = m_Context->m_Registry.get<RelationshipComponent>(child).NextSibling)
+				children.push_back(child);
+		}
+
 		ImGuiTreeNodeFlags flags = ((m_SelectionContext == entity) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_OpenOnArrow;
 		flags |= ImGuiTreeNodeFlags_SpanAvailWidth;
+		if (children.empty())
+			flags |= ImGuiTreeNodeFlags_Leaf;
 		bool opened = ImGui::TreeNodeEx((void*)(uint64_t)(uint32_t)entity, flags, tag.c_str());
 		
 		// 选中某个 Entity
@@ -90,10 +102,35 @@ namespace Hazel {
 			m_SelectionContext = entity;
 		}
 
+		// 把实体条目拖到另一个条目上，成为它的子节点
+		if (ImGui::BeginDragDropSource())
+		{
+			entt::entity handle = entity;
+			ImGui::SetDragDropPayload("SCENE_HIERARCHY_ENTITY", &handle, sizeof(entt::entity));
+			ImGui::Text("%s", tag.c_str());
+			ImGui::EndDragDropSource();
+		}
+
+		if (ImGui::BeginDragDropTarget())
+		{
+			if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("SCENE_HIERARCHY_ENTITY"))
+			{
+				Entity child = { *(const entt::entity*)payload->Data, m_Context.get() };
+				m_Context->SetParent(child, entity);
+			}
+			ImGui::EndDragDropTarget();
+		}
+
 		bool entityDeleted = false;
 		// 右键点击面板中的实体条目（触发区域为该窗口下的某一个 item 上 ）
 		if (ImGui::BeginPopupContextItem())
 		{
+			if (ImGui::MenuItem("Create Child Entity"))
+				m_Context->SetParent(m_Context->CreateEntity("Empty Entity"), entity);
+
+			if (entity.GetParent() && ImGui::MenuItem("Detach From Parent"))
+				m_Context->SetParent(entity, {});
+
 			if (ImGui::MenuItem("Delete Entity"))
 				entityDeleted = true;
 
@@ -102,16 +139,19 @@ namespace Hazel {
 
 		if (opened)
 		{
-			bool opened = ImGui::TreeNodeEx((void*)9817239, flags, tag.c_str());
-			if (opened)
-				ImGui::TreePop();
+			for (entt::entity child : children)
+			{
+				if (m_Context->m_Registry.valid(child))
+					DrawEntityNode({ child, m_Context.get() });
+			}
 			ImGui::TreePop();
 		}
 
 		if (entityDeleted)
 		{
+			// 子节点随之一起销毁，选中的可能是其中之一
 			m_Context->DestroyEntity(entity);
-			if (m_SelectionContext == entity)
+			if (m_SelectionContext && !m_Context->m_Registry.valid(m_SelectionContext))
 				m_SelectionContext = {};
 		}
 	}
@@ -215,6 +255,9 @@ namespace Hazel {
 			if (open)
 			{
 				uiFunction(component);
+
+				// 控件直接修改组件，无法逐项判断是否改变，展开时每帧通知一次，只影响选中的实体
+				entity.PatchComponent<T>();
 				ImGui::TreePop();
 			}
 
@@ -0,0 +1,1036 @@
+#include "Renderer2DBenchmark.h"
+
+#include "Hazel/Core/Timer.h"
+#include "Hazel/Scene/TransformKernel.h"
+
+#include <imgui/imgui.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <thread>
+
+/**
+* 堆上仍在使用的字节数，用于测量场景复制与快照实际占用的内存
+* 只在 Sandbox 中替换全局 operator new / delete，数组、nothrow 与带大小的版本默认都转发到这两个函数
+*/
+static std::atomic<size_t> s_LiveHeapBytes{ 0 };
+
+// 分配的内存前 16 字节保存大小，返回的地址保持 malloc 的对齐
+static constexpr size_t s_AllocationHeaderSize = 16;
+
+void* operator new(size_t size)
+{
+	void* block = std::malloc(size + s_AllocationHeaderSize);
+	if (!block)
+		throw std::bad_alloc();
+
+	*(size_t*)block = size;
+	s_LiveHeapBytes += size;
+	return (uint8_t*)block + s_AllocationHeaderSize;
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (!memory)
+		return;
+
+	uint8_t* block = (uint8_t*)memory - s_AllocationHeaderSize;
+	s_LiveHeapBytes -= *(size_t*)block;
+	std::free(block);
+}
+
+Renderer2DBenchmark::Renderer2DBenchmark()
+	: Layer("Renderer2DBenchmark"), m_CameraController(1280.0f / 720.0f)
+{
+}
+
+void Renderer2DBenchmark::OnAttach()
+{
+	HZ_PROFILE_FUNCTION();
+
+	// 固定随机种子，保证每次测试的数据一致
+	std::mt19937 engine(1234);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	m_Transforms.resize(m_QuadCount);
+	m_Colors.resize(m_QuadCount);
+	for (int i = 0; i < m_QuadCount; i++)
+	{
+		m_Transforms[i] = glm::translate(glm::mat4(1.0f), { position(engine), position(engine), 0.0f })
+			* glm::rotate(glm::mat4(1.0f), unit(engine) * glm::two_pi<float>(), { 0.0f, 0.0f, 1.0f })
+			* glm::scale(glm::mat4(1.0f), { 0.1f, 0.1f, 1.0f });
+		m_Colors[i] = { unit(engine), unit(engine), unit(engine), 1.0f };
+	}
+
+	// 纹理槽最多 32 个，0 号为白色纹理，所以最多测试 31 张不同纹理
+	for (uint32_t i = 0; i < 31; i++)
+	{
+		uint32_t pixel = 0xff000000 | (i * 0x00080402);
+		auto texture = Hazel::Texture2D::Create(1, 1);
+		texture->SetData(&pixel, sizeof(uint32_t));
+		m_Textures.push_back(texture);
+	}
+}
+
+void Renderer2DBenchmark::OnDetach()
+{
+	HZ_PROFILE_FUNCTION();
+}
+
+void Renderer2DBenchmark::OnUpdate(Hazel::Timestep ts)
+{
+	HZ_PROFILE_FUNCTION();
+
+	m_CameraController.OnUpdate(ts);
+
+	Hazel::Renderer2D::ResetStats();
+	Hazel::RenderCommand::SetClearColor({ 0.1f, 0.1f, 0.1f, 1 });
+	Hazel::RenderCommand::Clear();
+
+	if (m_RunThreadScaling)
+	{
+		m_RunThreadScaling = false;
+		RunThreadScaling();
+	}
+
+	if (m_RunJobScaling)
+	{
+		m_RunJobScaling = false;
+		RunJobScaling();
+	}
+
+	if (m_RunInstanceKernel)
+	{
+		m_RunInstanceKernel = false;
+		RunInstanceKernel();
+	}
+
+	if (m_RunTextureLookup)
+	{
+		m_RunTextureLookup = false;
+		RunTextureLookup();
+	}
+
+	if (m_RunPackedFormats)
+	{
+		m_RunPackedFormats = false;
+		RunPackedFormats();
+	}
+
+	if (m_RunTextureAtlas)
+	{
+		m_RunTextureAtlas = false;
+		RunTextureAtlas();
+	}
+
+	if (m_RunRetainedSprites)
+	{
+		m_RunRetainedSprites = false;
+		RunRetainedSprites();
+	}
+
+	if (m_RunWorldTransforms)
+	{
+		m_RunWorldTransforms = false;
+		RunWorldTransforms();
+	}
+
+	if (m_RunHierarchy)
+	{
+		m_RunHierarchy = false;
+		RunHierarchy();
+	}
+
+	if (m_RunSceneCopy)
+	{
+		m_RunSceneCopy = false;
+		RunSceneCopy();
+	}
+
+	if (m_RunSceneSnapshot)
+	{
+		m_RunSceneSnapshot = false;
+		RunSceneSnapshot();
+	}
+
+	if (m_RunUUIDLookup)
+	{
+		m_RunUUIDLookup = false;
+		RunUUIDLookup();
+	}
+}
+
+void Renderer2DBenchmark::RunThreadScaling()
+{
+	HZ_PROFILE_FUNCTION();
+
+	m_ThreadScalingResults.clear();
+
+	const uint32_t quadCount = (uint32_t)m_Transforms.size();
+	const uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<Hazel::Renderer2D::ThreadBatch> batches(maxThreads);
+
+	for (uint32_t threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+	{
+		const uint32_t chunkSize = (quadCount + threadCount - 1) / threadCount;
+
+		float totalMilliseconds = 0.0f;
+		for (int iteration = 0; iteration < m_Iterations; iteration++)
+		{
+			Hazel::Renderer2D::BeginScene(m_CameraController.GetCamera());
+
+			// 只统计 CPU 端的填充与合并时间，不包括 EndScene 中的上传与绘制
+			Hazel::Timer timer;
+			std::vector<std::thread> workers;
+			for (uint32_t t = 0; t < threadCount; t++)
+			{
+				workers.emplace_back([this, &batch = batches[t], first = t * chunkSize, last = std::min((t + 1) * chunkSize, quadCount)]()
+				{
+					batch.Reset();
+					for (uint32_t i = first; i < last; i++)
+						batch.DrawQuad(m_Transforms[i], m_Colors[i]);
+				});
+			}
+
+			for (auto& worker : workers)
+				worker.join();
+
+			for (uint32_t t = 0; t < threadCount; t++)
+				Hazel::Renderer2D::Submit(batches[t]);
+			totalMilliseconds += timer.ElapsedMillis();
+
+			Hazel::Renderer2D::EndScene();
+		}
+
+		float milliseconds = totalMilliseconds / m_Iterations;
+		m_ThreadScalingResults.push_back({ threadCount, milliseconds, quadCount / (milliseconds * 0.001) });
+	}
+}
+
+void Renderer2DBenchmark::RunJobScaling()
+{
+	HZ_PROFILE_FUNCTION();
+
+	m_JobScalingResults.clear();
+
+	const uint32_t quadCount = (uint32_t)m_Transforms.size();
+	const uint32_t maxJobs = Hazel::JobSystem::GetWorkerCount() + 1;
+
+	std::vector<Hazel::Renderer2D::ThreadBatch> batches(maxJobs);
+
+	for (uint32_t jobCount = 1; ; jobCount = std::min(jobCount * 2, maxJobs))
+	{
+		const uint32_t chunkSize = (quadCount + jobCount - 1) / jobCount;
+
+		float totalMilliseconds = 0.0f;
+		for (int iteration = 0; iteration < m_Iterations; iteration++)
+		{
+			Hazel::Renderer2D::BeginScene(m_CameraController.GetCamera());
+
+			Hazel::Timer timer;
+			Hazel::JobSystem::ParallelFor(quadCount, chunkSize, [this, &batches, chunkSize](uint32_t first, uint32_t last)
+			{
+				auto& batch = batches[first / chunkSize];
+				batch.Reset();
+				for (uint32_t i = first; i < last; i++)
+					batch.DrawQuad(m_Transforms[i], m_Colors[i]);
+			});
+
+			for (uint32_t j = 0; j < jobCount; j++)
+				Hazel::Renderer2D::Submit(batches[j]);
+			totalMilliseconds += timer.ElapsedMillis();
+
+			Hazel::Renderer2D::EndScene();
+		}
+
+		float milliseconds = totalMilliseconds / m_Iterations;
+		m_JobScalingResults.push_back({ jobCount, milliseconds, quadCount / (milliseconds * 0.001) });
+
+		if (jobCount == maxJobs)
+			break;
+	}
+
+	// 调度与执行空任务的平均耗时，衡量任务系统本身的开销
+	constexpr uint32_t emptyJobCount = 100000;
+	Hazel::Timer timer;
+	Hazel::JobCounter counter;
+	for (uint32_t i = 0; i < emptyJobCount; i++)
+		Hazel::JobSystem::Schedule([]() {}, &counter);
+	Hazel::JobSystem::Wait(counter);
+	m_NanosecondsPerJob = timer.ElapsedMillis() * 1000000.0f / emptyJobCount;
+}
+
+void Renderer2DBenchmark::RunInstanceKernel()
+{
+	HZ_PROFILE_FUNCTION();
+
+	using ISA = Hazel::QuadInstanceKernel::ISA;
+
+	m_InstanceKernelResults.clear();
+
+	const uint32_t quadCount = (uint32_t)m_Transforms.size();
+	const glm::vec4 color = { 0.8f, 0.2f, 0.3f, 1.0f };
+	const ISA previousISA = Hazel::QuadInstanceKernel::GetISA();
+
+	for (int isa = (int)ISA::Scalar; isa <= (int)Hazel::QuadInstanceKernel::GetSupportedISA(); isa++)
+	{
+		Hazel::QuadInstanceKernel::SetISA((ISA)isa);
+
+		InstanceKernelResult result = { (ISA)isa, 0.0f, 0.0f };
+		for (int iteration = 0; iteration < m_Iterations; iteration++)
+		{
+			Hazel::Renderer2D::BeginScene(m_CameraController.GetCamera());
+			{
+				Hazel::Timer timer;
+				for (uint32_t i = 0; i < quadCount; i++)
+					Hazel::Renderer2D::DrawQuad(m_Transforms[i], color);
+				result.DrawQuadMilliseconds += timer.ElapsedMillis();
+			}
+			Hazel::Renderer2D::EndScene();
+
+			Hazel::Renderer2D::BeginScene(m_CameraController.GetCamera());
+			{
+				Hazel::Timer timer;
+				Hazel::Renderer2D::DrawQuads(m_Transforms.data(), quadCount, color);
+				result.DrawQuadsMilliseconds += timer.ElapsedMillis();
+			}
+			Hazel::Renderer2D::EndScene();
+		}
+
+		result.DrawQuadMilliseconds /= m_Iterations;
+		result.DrawQuadsMilliseconds /= m_Iterations;
+		m_InstanceKernelResults.push_back(result);
+	}
+
+	Hazel::QuadInstanceKernel::SetISA(previousISA);
+}
+
+void Renderer2DBenchmark::RunTextureLookup()
+{
+	HZ_PROFILE_FUNCTION();
+
+	m_TextureLookupResults.clear();
+
+	const uint32_t quadCount = (uint32_t)m_Transforms.size();
+	for (uint32_t textureCount : { 1u, 8u, 31u })
+	{
+		TextureLookupResult result = { textureCount, 0.0f, 0.0f };
+		for (int iteration = 0; iteration < m_Iterations; iteration++)
+		{
+			// 参考：旧实现中每个 Quad 都要通过虚函数 operator== 线性扫描已绑定的纹理槽
+			{
+				std::array<Hazel::Ref<Hazel::Texture2D>, 32> slots;
+				uint32_t slotCount = 1;
+				for (uint32_t i = 0; i < textureCount; i++)
+					slots[slotCount++] = m_Textures[i];
+
+				Hazel::Timer timer;
+				uint32_t checksum = 0;
+				for (uint32_t i = 0; i < quadCount; i++)
+				{
+					const auto& texture = m_Textures[i % textureCount];
+					for (uint32_t slot = 1; slot < slotCount; slot++)
+					{
+						if (*slots[slot] == *texture)
+						{
+							checksum += slot;
+							break;
+						}
+					}
+				}
+				result.LinearScanMilliseconds += timer.ElapsedMillis();
+
+				// 防止编译器优化掉整个循环
+				if (checksum == 0)
+					HZ_WARNING("Texture lookup checksum is zero");
+			}
+
+			Hazel::Renderer2D::BeginScene(m_CameraController.GetCamera());
+			{
+				Hazel::Timer timer;
+				for (uint32_t i = 0; i < quadCount; i++)
+					Hazel::Renderer2D::DrawQuad(m_Transforms[i], m_Textures[i % textureCount]);
+				result.DrawQuadMilliseconds += timer.ElapsedMillis();
+			}
+			Hazel::Renderer2D::EndScene();
+		}
+
+		result.LinearScanMilliseconds /= m_Iterations;
+		result.DrawQuadMilliseconds /= m_Iterations;
+		m_TextureLookupResults.push_back(result);
+	}
+}
+
+void Renderer2DBenchmark::RunPackedFormats()
+{
+	HZ_PROFILE_FUNCTION();
+
+	// 改为实例化与压缩格式之前的布局：每个 Quad 4 个全浮点顶点
+	struct FloatQuadVertex
+	{
+		glm::vec3 Position;
+		glm::vec4 Color;
+		glm::vec2 TexCoord;
+		float TexIndex;
+		float TilingFactor;
+		int EntityID;
+	};
+
+	// 压缩之前的实例布局
+	struct FloatQuadInstance
+	{
+		glm::vec3 AxisX;
+		float TexIndex;
+		glm::vec3 AxisY;
+		float TilingFactor;
+		glm::vec3 Translation;
+		int EntityID;
+		glm::vec4 Color;
+		glm::vec4 TexRect;
+	};
+
+	constexpr glm::vec4 quadVertexPositions[] = { { -0.5f, -0.5f, 0.0f, 1.0f }, { 0.5f, -0.5f, 0.0f, 1.0f }, { 0.5f, 0.5f, 0.0f, 1.0f }, { -0.5f, 0.5f, 0.0f, 1.0f } };
+	constexpr glm::vec2 texCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+	const glm::vec4 texRect = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+	m_PackedFormatResults.clear();
+
+	const uint32_t quadCount = (uint32_t)m_Transforms.size();
+	std::vector<FloatQuadVertex> floatVertices(quadCount * 4);
+	std::vector<FloatQuadInstance> floatInstances(quadCount);
+	std::vector<Hazel::QuadInstance> packedInstances(quadCount);
+
+	PackedFormatResult floatVertexResult = { "Float vertices", (uint32_t)sizeof(FloatQuadVertex) * 4, 0, 0.0f };
+	PackedFormatResult floatInstanceResult = { "Float instance", (uint32_t)sizeof(FloatQuadInstance), 0, 0.0f };
+	PackedFormatResult packedInstanceResult = { "Packed instance", (uint32_t)sizeof(Hazel::QuadInstance), 0, 0.0f };
+
+	// 三种布局都用同样的逐个 Quad 标量写入，只比较布局本身的差别
+	for (int iteration = 0; iteration < m_Iterations; iteration++)
+	{
+		{
+			Hazel::Timer timer;
+			FloatQuadVertex* dst = floatVertices.data();
+			for (uint32_t q = 0; q < quadCount; q++)
+			{
+				for (size_t i = 0; i < 4; i++)
+				{
+					dst->Position = m_Transforms[q] * quadVertexPositions[i];
+					dst->Color = m_Colors[q];
+					dst->TexCoord = texCoords[i];
+					dst->TexIndex = 0.0f;
+					dst->TilingFactor = 1.0f;
+					dst->EntityID = (int)q;
+					dst++;
+				}
+			}
+			floatVertexResult.FillMilliseconds += timer.ElapsedMillis();
+		}
+
+		{
+			Hazel::Timer timer;
+			for (uint32_t q = 0; q < quadCount; q++)
+			{
+				FloatQuadInstance& dst = floatInstances[q];
+				dst.AxisX = m_Transforms[q][0];
+				dst.TexIndex = 0.0f;
+				dst.AxisY = m_Transforms[q][1];
+				dst.TilingFactor = 1.0f;
+				dst.Translation = m_Transforms[q][3];
+				dst.EntityID = (int)q;
+				dst.Color = m_Colors[q];
+				dst.TexRect = texRect;
+			}
+			floatInstanceResult.FillMilliseconds += timer.ElapsedMillis();
+		}
+
+		{
+			Hazel::Timer timer;
+			for (uint32_t q = 0; q < quadCount; q++)
+			{
+				Hazel::QuadInstance& dst = packedInstances[q];
+				dst.AxisX = m_Transforms[q][0];
+				dst.EntityID = (int)q;
+				dst.AxisY = m_Transforms[q][1];
+				dst.Color = glm::packUnorm4x8(m_Colors[q]);
+				dst.Translation = m_Transforms[q][3];
+				dst.TexIndex = 0;
+				for (int i = 0; i < 4; i++)
+					dst.TexRect[i] = glm::packHalf1x16(texRect[i]);
+				dst.TilingFactor = glm::packHalf1x16(1.0f);
+			}
+			packedInstanceResult.FillMilliseconds += timer.ElapsedMillis();
+		}
+	}
+
+	for (PackedFormatResult* result : { &floatVertexResult, &floatInstanceResult, &packedInstanceResult })
+	{
+		result->BytesPerFrame = (uint64_t)result->BytesPerQuad * quadCount;
+		result->FillMilliseconds /= m_Iterations;
+		m_PackedFormatResults.push_back(*result);
+	}
+}
+
+void Renderer2DBenchmark::RunTextureAtlas()
+{
+	HZ_PROFILE_FUNCTION();
+
+	constexpr uint32_t textureCount = 256;
+	constexpr uint32_t textureSize = 16;
+	if (m_AtlasTextures.empty())
+	{
+		std::vector<uint32_t> pixels(textureSize * textureSize);
+		for (uint32_t i = 0; i < textureCount; i++)
+		{
+			std::fill(pixels.begin(), pixels.end(), 0xff000000 | (i * 0x00010203));
+			auto texture = Hazel::Texture2D::Create(textureSize, textureSize);
+			texture->SetData(pixels.data(), (uint32_t)pixels.size() * sizeof(uint32_t));
+			m_AtlasTextures.push_back(texture);
+		}
+	}
+
+	// 打包时间不计入绘制耗时
+	Hazel::TextureAtlas atlas;
+	std::vector<Hazel::Ref<Hazel::SubTexture2D>> subTextures;
+	for (const auto& texture : m_AtlasTextures)
+		subTextures.push_back(atlas.Add(texture));
+	m_AtlasPageCount = atlas.GetPageCount();
+
+	m_TextureAtlasResults.clear();
+
+	const uint32_t quadCount = (uint32_t)m_Transforms.size();
+	const bool previousSorting = Hazel::Renderer2D::IsSortingEnabled();
+	for (bool sorted : { false, true })
+	{
+		Hazel::Renderer2D::SetSortingEnabled(sorted);
+
+		TextureAtlasResult textureResult = { "Textures", sorted, 0, 0.0f };
+		TextureAtlasResult atlasResult = { "Atlas", sorted, 0, 0.0f };
+		for (int iteration = 0; iteration < m_Iterations; iteration++)
+		{
+			for (TextureAtlasResult* result : { &textureResult, &atlasResult })
+			{
+				uint32_t drawCalls = Hazel::Renderer2D::GetStats().DrawCalls;
+
+				Hazel::Timer timer;
+				Hazel::Renderer2D::BeginScene(m_CameraController.GetCamera());
+				for (uint32_t i = 0; i < quadCount; i++)
+				{
+					if (result == &atlasResult)
+						Hazel::Renderer2D::DrawQuad(m_Transforms[i], subTextures[i % textureCount]);
+					else
+						Hazel::Renderer2D::DrawQuad(m_Transforms[i], m_AtlasTextures[i % textureCount]);
+				}
+				Hazel::Renderer2D::EndScene();
+				result->Milliseconds += timer.ElapsedMillis();
+
+				result->DrawCalls = Hazel::Renderer2D::GetStats().DrawCalls - drawCalls;
+			}
+		}
+
+		for (TextureAtlasResult* result : { &textureResult, &atlasResult })
+		{
+			result->Milliseconds /= m_Iterations;
+			m_TextureAtlasResults.push_back(*result);
+		}
+	}
+	Hazel::Renderer2D::SetSortingEnabled(previousSorting);
+}
+
+void Renderer2DBenchmark::RunRetainedSprites()
+{
+	HZ_PROFILE_FUNCTION();
+
+	std::mt19937 engine(1234);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	Hazel::Scene scene;
+	std::vector<Hazel::Entity> entities;
+	entities.reserve(m_QuadCount);
+	for (int i = 0; i < m_QuadCount; i++)
+	{
+		Hazel::Entity entity = scene.CreateEntity();
+		auto& transform = entity.GetComponent<Hazel::TransformComponent>();
+		transform.Translation = { position(engine), position(engine), 0.0f };
+		transform.Rotation.z = unit(engine) * glm::two_pi<float>();
+		transform.Scale = { 0.1f, 0.1f, 1.0f };
+		entity.AddComponent<Hazel::SpriteRendererComponent>(m_Colors[i]);
+		entities.push_back(entity);
+	}
+
+	Hazel::EditorCamera camera(30.0f, 1280.0f / 720.0f, 0.1f, 1000.0f);
+
+	// 第一帧生成全部实例，不计入耗时
+	scene.OnUpdateEditor(0.0f, camera);
+
+	m_RetainedSpritesResults.clear();
+	for (float movingPercent : { 0.0f, 1.0f, 10.0f, 100.0f })
+	{
+		const size_t movingCount = (size_t)(entities.size() * movingPercent / 100.0f);
+
+		RetainedSpritesResult result = { movingPercent, 0.0f, 0.0f };
+		for (int iteration = 0; iteration < m_Iterations; iteration++)
+		{
+			const float offset = (iteration & 1) ? 0.01f : -0.01f;
+			for (size_t i = 0; i < movingCount; i++)
+			{
+				entities[i].PatchComponent<Hazel::TransformComponent>([offset](auto& transform)
+				{
+					transform.Translation.x += offset;
+				});
+			}
+
+			// 逐帧提交：每个精灵都重新计算变换矩阵并生成实例
+			{
+				Hazel::Timer timer;
+				Hazel::Renderer2D::BeginScene(camera);
+				auto view = scene.GetAllEntitiesWith<Hazel::TransformComponent, Hazel::SpriteRendererComponent>();
+				for (auto entity : view)
+				{
+					auto [transform, sprite] = view.get<Hazel::TransformComponent, Hazel::SpriteRendererComponent>(entity);
+					Hazel::Renderer2D::DrawSprite(transform.GetTransform(), sprite, (int)entity);
+				}
+				Hazel::Renderer2D::EndScene();
+				result.ImmediateMilliseconds += timer.ElapsedMillis();
+			}
+
+			// 保留模式：只重新生成并上传移动过的精灵
+			{
+				Hazel::Timer timer;
+				scene.OnUpdateEditor(0.0f, camera);
+				result.RetainedMilliseconds += timer.ElapsedMillis();
+			}
+		}
+
+		result.ImmediateMilliseconds /= m_Iterations;
+		result.RetainedMilliseconds /= m_Iterations;
+		m_RetainedSpritesResults.push_back(result);
+	}
+}
+
+void Renderer2DBenchmark::RunWorldTransforms()
+{
+	HZ_PROFILE_FUNCTION();
+
+	std::mt19937 engine(1234);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	std::vector<Hazel::TransformComponent> transforms(m_QuadCount);
+	std::vector<Hazel::TransformComponent*> pointers(m_QuadCount);
+	for (int i = 0; i < m_QuadCount; i++)
+	{
+		transforms[i].Translation = { position(engine), position(engine), 0.0f };
+		transforms[i].Rotation = { 0.0f, 0.0f, unit(engine) * glm::two_pi<float>() };
+		transforms[i].Scale = { 0.1f, 0.1f, 1.0f };
+		pointers[i] = &transforms[i];
+	}
+
+	m_ScalarTransformMilliseconds = 0.0f;
+	m_KernelTransformMilliseconds = 0.0f;
+	for (int iteration = 0; iteration < m_Iterations; iteration++)
+	{
+		{
+			Hazel::Timer timer;
+			Hazel::TransformKernel::UpdateWorldTransformsScalar(pointers.data(), (uint32_t)pointers.size());
+			m_ScalarTransformMilliseconds += timer.ElapsedMillis();
+		}
+		{
+			Hazel::Timer timer;
+			Hazel::TransformKernel::UpdateWorldTransforms(pointers.data(), (uint32_t)pointers.size());
+			m_KernelTransformMilliseconds += timer.ElapsedMillis();
+		}
+	}
+	m_ScalarTransformMilliseconds /= m_Iterations;
+	m_KernelTransformMilliseconds /= m_Iterations;
+}
+
+void Renderer2DBenchmark::RunHierarchy()
+{
+	HZ_PROFILE_FUNCTION();
+
+	constexpr int nodeCount = 100000;
+	constexpr int rootCount = 100;
+
+	std::mt19937 engine(1234);
+	std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+
+	// 每个节点随机挂到之前创建的某个节点下，平均深度约为 ln(n)
+	Hazel::Scene scene;
+	std::vector<Hazel::Entity> entities;
+	entities.reserve(nodeCount);
+	for (int i = 0; i < nodeCount; i++)
+	{
+		Hazel::Entity entity = scene.CreateEntity();
+		entity.GetComponent<Hazel::TransformComponent>().Translation = { position(engine), position(engine), 0.0f };
+		if (i >= rootCount)
+			scene.SetParent(entity, entities[std::uniform_int_distribution<int>(0, i - 1)(engine)]);
+		entities.push_back(entity);
+	}
+
+	Hazel::EditorCamera camera(30.0f, 1280.0f / 720.0f, 0.1f, 1000.0f);
+
+	{
+		Hazel::Timer timer;
+		scene.OnUpdateEditor(0.0f, camera);
+		m_HierarchyBuildMilliseconds = timer.ElapsedMillis();
+	}
+
+	// 移动所有根节点，整个层级的世界矩阵都需要重新计算
+	m_HierarchyPropagateMilliseconds = 0.0f;
+	for (int iteration = 0; iteration < m_Iterations; iteration++)
+	{
+		const float offset = (iteration & 1) ? 0.01f : -0.01f;
+		for (int i = 0; i < rootCount; i++)
+		{
+			entities[i].PatchComponent<Hazel::TransformComponent>([offset](auto& transform)
+			{
+				transform.Rotation.z += offset;
+			});
+		}
+
+		Hazel::Timer timer;
+		scene.OnUpdateEditor(0.0f, camera);
+		m_HierarchyPropagateMilliseconds += timer.ElapsedMillis();
+	}
+	m_HierarchyPropagateMilliseconds /= m_Iterations;
+}
+
+void Renderer2DBenchmark::RunSceneCopy()
+{
+	HZ_PROFILE_FUNCTION();
+
+	std::mt19937 engine(1234);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	m_SceneCopyResults.clear();
+	for (uint32_t entityCount : { 10000u, 100000u, 1000000u })
+	{
+		Hazel::Ref<Hazel::Scene> source = Hazel::CreateRef<Hazel::Scene>();
+		for (uint32_t i = 0; i < entityCount; i++)
+		{
+			Hazel::Entity entity = source->CreateEntity();
+			entity.GetComponent<Hazel::TransformComponent>().Translation = { position(engine), position(engine), 0.0f };
+			entity.AddComponent<Hazel::SpriteRendererComponent>(glm::vec4{ unit(engine), unit(engine), unit(engine), 1.0f });
+		}
+
+		// 100 万个实体时每次复制耗时较长，只测一次
+		const int iterations = entityCount >= 1000000 ? 1 : m_Iterations;
+
+		// 原来的做法：逐个实体用 UUID 创建，再按 UUID 查找目标实体复制每个组件
+		float perEntityMilliseconds = 0.0f;
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			Hazel::Timer timer;
+			Hazel::Ref<Hazel::Scene> copy = Hazel::CreateRef<Hazel::Scene>();
+			std::unordered_map<Hazel::UUID, Hazel::Entity> entityMap;
+			for (auto e : source->GetAllEntitiesWith<Hazel::IDComponent>())
+			{
+				Hazel::Entity entity = { e, source.get() };
+				Hazel::UUID uuid = entity.GetComponent<Hazel::IDComponent>().ID;
+				entityMap[uuid] = copy->CreateEntityWithUUID(uuid, entity.GetComponent<Hazel::TagComponent>().Tag);
+			}
+			for (auto e : source->GetAllEntitiesWith<Hazel::IDComponent>())
+			{
+				Hazel::Entity entity = { e, source.get() };
+				Hazel::Entity target = entityMap.at(entity.GetComponent<Hazel::IDComponent>().ID);
+				target.AddOrReplaceComponent<Hazel::TransformComponent>(entity.GetComponent<Hazel::TransformComponent>());
+				target.AddOrReplaceComponent<Hazel::SpriteRendererComponent>(entity.GetComponent<Hazel::SpriteRendererComponent>());
+			}
+			perEntityMilliseconds += timer.ElapsedMillis();
+		}
+
+		float bulkMilliseconds = 0.0f;
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			Hazel::Timer timer;
+			Hazel::Ref<Hazel::Scene> copy = Hazel::Scene::Copy(source);
+			bulkMilliseconds += timer.ElapsedMillis();
+		}
+
+		m_SceneCopyResults.push_back({ entityCount, perEntityMilliseconds / iterations, bulkMilliseconds / iterations });
+	}
+}
+
+void Renderer2DBenchmark::RunSceneSnapshot()
+{
+	HZ_PROFILE_FUNCTION();
+
+	constexpr int entityCount = 100000;
+	constexpr int movingCount = entityCount / 100;
+
+	std::mt19937 engine(1234);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	Hazel::Ref<Hazel::Scene> scene = Hazel::CreateRef<Hazel::Scene>();
+	std::vector<Hazel::Entity> entities;
+	entities.reserve(entityCount);
+	for (int i = 0; i < entityCount; i++)
+	{
+		Hazel::Entity entity = scene->CreateEntity();
+		entity.GetComponent<Hazel::TransformComponent>().Translation = { position(engine), position(engine), 0.0f };
+		entity.AddComponent<Hazel::SpriteRendererComponent>(glm::vec4{ unit(engine), unit(engine), unit(engine), 1.0f });
+		entities.push_back(entity);
+	}
+
+	// 内存按结果存活期间增加的堆字节数计算，包括 registry、组件存储与快照页在内的全部分配
+	float copyMilliseconds = 0.0f, captureMilliseconds = 0.0f, incrementalMilliseconds = 0.0f, restoreMilliseconds = 0.0f;
+	size_t copyBytes = 0, captureBytes = 0, incrementalBytes = 0, restoreBytes = 0;
+	for (int iteration = 0; iteration < m_Iterations; iteration++)
+	{
+		{
+			size_t liveBytes = s_LiveHeapBytes;
+			Hazel::Timer timer;
+			Hazel::Ref<Hazel::Scene> copy = Hazel::Scene::Copy(scene);
+			copyMilliseconds += timer.ElapsedMillis();
+			copyBytes = s_LiveHeapBytes - liveBytes;
+		}
+
+		Hazel::Ref<Hazel::SceneSnapshot> snapshot;
+		{
+			size_t liveBytes = s_LiveHeapBytes;
+			Hazel::Timer timer;
+			snapshot = Hazel::SceneSnapshot::Capture(scene);
+			captureMilliseconds += timer.ElapsedMillis();
+			captureBytes = s_LiveHeapBytes - liveBytes;
+		}
+
+		// 分散地移动少量实体，模拟两次快照之间的一段运行
+		for (int i = 0; i < movingCount; i++)
+		{
+			entities[std::uniform_int_distribution<int>(0, entityCount - 1)(engine)].PatchComponent<Hazel::TransformComponent>([](auto& transform)
+			{
+				transform.Translation.x += 0.01f;
+			});
+		}
+
+		// 增量快照与 snapshot 共享未变化的页，只计算它自己新分配的内存
+		Hazel::Ref<Hazel::SceneSnapshot> incremental;
+		{
+			size_t liveBytes = s_LiveHeapBytes;
+			Hazel::Timer timer;
+			incremental = Hazel::SceneSnapshot::Capture(scene, snapshot);
+			incrementalMilliseconds += timer.ElapsedMillis();
+			incrementalBytes = s_LiveHeapBytes - liveBytes;
+		}
+
+		{
+			size_t liveBytes = s_LiveHeapBytes;
+			Hazel::Timer timer;
+			Hazel::Ref<Hazel::Scene> restored = incremental->Restore();
+			restoreMilliseconds += timer.ElapsedMillis();
+			restoreBytes = s_LiveHeapBytes - liveBytes;
+		}
+	}
+
+	m_SceneSnapshotResults.clear();
+	m_SceneSnapshotResults.push_back({ "Scene::Copy", copyMilliseconds / m_Iterations, copyBytes });
+	m_SceneSnapshotResults.push_back({ "Capture", captureMilliseconds / m_Iterations, captureBytes });
+	m_SceneSnapshotResults.push_back({ "Capture (1% moved)", incrementalMilliseconds / m_Iterations, incrementalBytes });
+	m_SceneSnapshotResults.push_back({ "Restore", restoreMilliseconds / m_Iterations, restoreBytes });
+}
+
+void Renderer2DBenchmark::RunUUIDLookup()
+{
+	HZ_PROFILE_FUNCTION();
+
+	constexpr int entityCount = 100000;
+	constexpr int lookupCount = 1000000;
+	// 遍历查找太慢，只测少量
+	constexpr int scanLookupCount = 100;
+
+	Hazel::Scene scene;
+	std::vector<Hazel::UUID> uuids;
+	uuids.reserve(entityCount);
+	std::unordered_map<Hazel::UUID, entt::entity> entityMap;
+	for (int i = 0; i < entityCount; i++)
+	{
+		Hazel::Entity entity = scene.CreateEntity();
+		uuids.push_back(entity.GetUUID());
+		entityMap[entity.GetUUID()] = entity;
+	}
+
+	std::mt19937 engine(1234);
+	std::vector<Hazel::UUID> lookups;
+	lookups.reserve(lookupCount);
+	for (int i = 0; i < lookupCount; i++)
+		lookups.push_back(uuids[std::uniform_int_distribution<int>(0, entityCount - 1)(engine)]);
+
+	// 累加查找结果，避免查找被优化掉
+	uint64_t checksum = 0;
+
+	{
+		auto view = scene.GetAllEntitiesWith<Hazel::IDComponent>();
+		Hazel::Timer timer;
+		for (int i = 0; i < scanLookupCount; i++)
+		{
+			for (auto entity : view)
+			{
+				if (view.get(entity).ID == lookups[i])
+				{
+					checksum += (uint32_t)entity;
+					break;
+				}
+			}
+		}
+		m_ScanLookupNanoseconds = timer.ElapsedMillis() * 1000000.0f / scanLookupCount;
+	}
+
+	{
+		Hazel::Timer timer;
+		for (const Hazel::UUID& uuid : lookups)
+			checksum += (uint32_t)entityMap.find(uuid)->second;
+		m_UnorderedMapLookupNanoseconds = timer.ElapsedMillis() * 1000000.0f / lookupCount;
+	}
+
+	{
+		Hazel::Timer timer;
+		for (const Hazel::UUID& uuid : lookups)
+			checksum += (uint32_t)scene.GetEntityByUUID(uuid);
+		m_SceneLookupNanoseconds = timer.ElapsedMillis() * 1000000.0f / lookupCount;
+	}
+
+	if (checksum == 0)
+		HZ_WARNING("UUID lookup checksum is zero");
+}
+
+void Renderer2DBenchmark::OnImGuiRender()
+{
+	HZ_PROFILE_FUNCTION();
+
+	ImGui::Begin("Renderer2D Benchmark");
+
+	ImGui::Text("Quads: %d", m_QuadCount);
+	ImGui::SliderInt("Iterations", &m_Iterations, 1, 100);
+
+	if (ImGui::CollapsingHeader("Thread scaling", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		if (ImGui::Button("Run##ThreadScaling"))
+			m_RunThreadScaling = true;
+
+		for (const auto& result : m_ThreadScalingResults)
+			ImGui::Text("%2u threads: %8.3f ms  %12.0f quads/sec", result.ThreadCount, result.Milliseconds, result.QuadsPerSecond);
+	}
+
+	if (ImGui::CollapsingHeader("Job system", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		ImGui::Text("Workers: %u (+ main thread)", Hazel::JobSystem::GetWorkerCount());
+		if (ImGui::Button("Run##JobScaling"))
+			m_RunJobScaling = true;
+
+		for (const auto& result : m_JobScalingResults)
+			ImGui::Text("%2u jobs: %8.3f ms  %12.0f quads/sec", result.ThreadCount, result.Milliseconds, result.QuadsPerSecond);
+		ImGui::Text("Empty job overhead: %6.1f ns", m_NanosecondsPerJob);
+	}
+
+	if (ImGui::CollapsingHeader("Instance kernel", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		ImGui::Text("Supported: %s", Hazel::QuadInstanceKernel::GetISAName(Hazel::QuadInstanceKernel::GetSupportedISA()));
+		ImGui::Text("Upload per quad: %u bytes", (uint32_t)sizeof(Hazel::QuadInstance));
+		if (ImGui::Button("Run##InstanceKernel"))
+			m_RunInstanceKernel = true;
+
+		for (const auto& result : m_InstanceKernelResults)
+			ImGui::Text("%-6s DrawQuad: %8.3f ms  DrawQuads: %8.3f ms", Hazel::QuadInstanceKernel::GetISAName(result.ISA), result.DrawQuadMilliseconds, result.DrawQuadsMilliseconds);
+	}
+
+	if (ImGui::CollapsingHeader("Texture lookup", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		if (ImGui::Button("Run##TextureLookup"))
+			m_RunTextureLookup = true;
+
+		for (const auto& result : m_TextureLookupResults)
+			ImGui::Text("%2u textures: linear scan only %8.3f ms  textured DrawQuad %8.3f ms", result.TextureCount, result.LinearScanMilliseconds, result.DrawQuadMilliseconds);
+	}
+
+	if (ImGui::CollapsingHeader("Packed formats", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		ImGui::Text("Circle: %u bytes  Line: %u bytes", (uint32_t)sizeof(Hazel::CircleInstance), (uint32_t)sizeof(Hazel::LineInstance));
+		if (ImGui::Button("Run##PackedFormats"))
+			m_RunPackedFormats = true;
+
+		for (const auto& result : m_PackedFormatResults)
+			ImGui::Text("%-16s %4u B/quad  %8.2f MB/frame  fill %8.3f ms", result.Name, result.BytesPerQuad, result.BytesPerFrame / (1024.0 * 1024.0), result.FillMilliseconds);
+	}
+
+	if (ImGui::CollapsingHeader("Texture atlas", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		if (ImGui::Button("Run##TextureAtlas"))
+			m_RunTextureAtlas = true;
+
+		ImGui::Text("Texture binding: %s", Hazel::Renderer2D::IsBindlessTexturesEnabled() ? "bindless" : "24 slots + 8 texture arrays");
+		if (!m_TextureAtlasResults.empty())
+			ImGui::Text("256 textures packed into %u page(s)", m_AtlasPageCount);
+		for (const auto& result : m_TextureAtlasResults)
+			ImGui::Text("%-8s %-10s %6u draw calls  %8.3f ms", result.Name, result.Sorted ? "sorted" : "submission", result.DrawCalls, result.Milliseconds);
+	}
+
+	if (ImGui::CollapsingHeader("Retained sprites", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		if (ImGui::Button("Run##RetainedSprites"))
+			m_RunRetainedSprites = true;
+
+		for (const auto& result : m_RetainedSpritesResults)
+			ImGui::Text("%5.1f%% moving: immediate %8.3f ms  retained %8.3f ms", result.MovingPercent, result.ImmediateMilliseconds, result.RetainedMilliseconds);
+	}
+
+	if (ImGui::CollapsingHeader("World transforms", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		if (ImGui::Button("Run##WorldTransforms"))
+			m_RunWorldTransforms = true;
+
+		ImGui::Text("GetTransform: %8.3f ms  TransformKernel: %8.3f ms", m_ScalarTransformMilliseconds, m_KernelTransformMilliseconds);
+	}
+
+	if (ImGui::CollapsingHeader("Transform hierarchy", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		if (ImGui::Button("Run##Hierarchy"))
+			m_RunHierarchy = true;
+
+		ImGui::Text("First frame (sort): %8.3f ms  Move roots: %8.3f ms", m_HierarchyBuildMilliseconds, m_HierarchyPropagateMilliseconds);
+	}
+
+	if (ImGui::CollapsingHeader("Scene copy", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		if (ImGui::Button("Run##SceneCopy"))
+			m_RunSceneCopy = true;
+
+		for (const auto& result : m_SceneCopyResults)
+			ImGui::Text("%8u entities: per entity %9.3f ms  bulk %9.3f ms", result.EntityCount, result.PerEntityMilliseconds, result.BulkMilliseconds);
+	}
+
+	if (ImGui::CollapsingHeader("Scene snapshots", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		if (ImGui::Button("Run##SceneSnapshot"))
+			m_RunSceneSnapshot = true;
+
+		for (const auto& result : m_SceneSnapshotResults)
+			ImGui::Text("%-20s %8.3f ms  %8.2f MB", result.Name, result.Milliseconds, result.Bytes / (1024.0 * 1024.0));
+	}
+
+	if (ImGui::CollapsingHeader("UUID lookup", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		if (ImGui::Button("Run##UUIDLookup"))
+			m_RunUUIDLookup = true;
+
+		ImGui::Text("Scan: %10.1f ns  unordered_map: %6.1f ns  GetEntityByUUID: %6.1f ns", m_ScanLookupNanoseconds, m_UnorderedMapLookupNanoseconds, m_SceneLookupNanoseconds);
+	}
+
+	ImGui::End();
+}
+
+void Renderer2DBenchmark::OnEvent(Hazel::Event& e)
+{
+	m_CameraController.OnEvent(e);
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Hazel.h"
+
+/**
+* Renderer2D 的 CPU 端性能测试图层
+* 在 SandboxApp 中 PushLayer 后通过 ImGui 面板触发，每项测试在 OnUpdate 中执行（需要有效的渲染上下文）
+*/
+class Renderer2DBenchmark : public Hazel::Layer
+{
+public:
+	Renderer2DBenchmark();
+	virtual ~Renderer2DBenchmark() = default;
+
+	virtual void OnAttach() override;
+	virtual void OnDetach() override;
+
+	void OnUpdate(Hazel::Timestep ts) override;
+	virtual void OnImGuiRender() override;
+	void OnEvent(Hazel::Event& e) override;
+private:
+	/** 多线程填充 ThreadBatch 并合并提交，统计不同线程数下的 quads/sec */
+	void RunThreadScaling();
+	/** 与 RunThreadScaling 相同的负载改用 JobSystem::ParallelFor 切成不同数量的任务，并统计空任务的调度开销 */
+	void RunJobScaling();
+	/** 对比各指令集实现下逐个 DrawQuad 与批量 DrawQuads 的耗时 */
+	void RunInstanceKernel();
+	/** 在 1 / 8 / 31 张不同纹理间轮流绘制，对比纹理槽查找耗时 */
+	void RunTextureLookup();
+	/** 对比旧的浮点顶点布局与压缩实例布局每帧上传的字节数和 CPU 填充耗时 */
+	void RunPackedFormats();
+	/** 在 256 张小纹理间轮流绘制，对比直接使用纹理与使用图集子纹理时的绘制调用次数 */
+	void RunTextureAtlas();
+	/** 场景中部分精灵每帧移动时，对比逐帧提交全部精灵与保留模式只重新生成移动精灵的耗时 */
+	void RunRetainedSprites();
+	/** 对比逐个调用 TransformComponent::GetTransform 与 TransformKernel 批量计算世界矩阵的耗时 */
+	void RunWorldTransforms();
+	/** 10 万个节点的随机层级，对比建立层级后第一帧（含按深度排序）与每帧移动全部根节点时的传播耗时 */
+	void RunHierarchy();
+	/** 1 万 / 10 万 / 100 万个精灵实体，对比逐个实体创建并复制组件与 Scene::Copy 整体复制组件存储的耗时 */
+	void RunSceneCopy();
+	/** 10 万个精灵实体，对比 Scene::Copy 与首次 / 增量捕获快照的耗时和新分配的内存，增量捕获前移动 1% 的实体 */
+	void RunSceneSnapshot();
+	/** 10 万个实体中按 UUID 随机查找，对比遍历 IDComponent、std::unordered_map 与 Scene::GetEntityByUUID 每次查找的耗时 */
+	void RunUUIDLookup();
+private:
+	Hazel::OrthographicCameraController m_CameraController;
+
+	int m_QuadCount = 200000;
+	int m_Iterations = 10;
+	std::vector<glm::mat4> m_Transforms;
+	std::vector<glm::vec4> m_Colors;
+
+	bool m_RunThreadScaling = false;
+
+	struct ThreadScalingResult
+	{
+		uint32_t ThreadCount;
+		float Milliseconds;
+		double QuadsPerSecond;
+	};
+	std::vector<ThreadScalingResult> m_ThreadScalingResults;
+
+	bool m_RunJobScaling = false;
+	std::vector<ThreadScalingResult> m_JobScalingResults;
+	float m_NanosecondsPerJob = 0.0f;
+
+	bool m_RunInstanceKernel = false;
+
+	struct InstanceKernelResult
+	{
+		Hazel::QuadInstanceKernel::ISA ISA;
+		float DrawQuadMilliseconds;
+		float DrawQuadsMilliseconds;
+	};
+	std::vector<InstanceKernelResult> m_InstanceKernelResults;
+
+	bool m_RunTextureLookup = false;
+	std::vector<Hazel::Ref<Hazel::Texture2D>> m_Textures;
+
+	struct TextureLookupResult
+	{
+		uint32_t TextureCount;
+		float LinearScanMilliseconds;
+		float DrawQuadMilliseconds;
+	};
+	std::vector<TextureLookupResult> m_TextureLookupResults;
+
+	bool m_RunPackedFormats = false;
+
+	struct PackedFormatResult
+	{
+		const char* Name;
+		uint32_t BytesPerQuad;
+		uint64_t BytesPerFrame;
+		float FillMilliseconds;
+	};
+	std::vector<PackedFormatResult> m_PackedFormatResults;
+
+	bool m_RunTextureAtlas = false;
+	std::vector<Hazel::Ref<Hazel::Texture2D>> m_AtlasTextures;
+
+	struct TextureAtlasResult
+	{
+		const char* Name;
+		bool Sorted;
+		uint32_t DrawCalls;
+		float Milliseconds;
+	};
+	std::vector<TextureAtlasResult> m_TextureAtlasResults;
+	uint32_t m_AtlasPageCount = 0;
+
+	bool m_RunRetainedSprites = false;
+
+	struct RetainedSpritesResult
+	{
+		float MovingPercent;
+		float ImmediateMilliseconds;
+		float RetainedMilliseconds;
+	};
+	std::vector<RetainedSpritesResult> m_RetainedSpritesResults;
+
+	bool m_RunWorldTransforms = false;
+	float m_ScalarTransformMilliseconds = 0.0f;
+	float m_KernelTransformMilliseconds = 0.0f;
+
+	bool m_RunHierarchy = false;
+	float m_HierarchyBuildMilliseconds = 0.0f;
+	float m_HierarchyPropagateMilliseconds = 0.0f;
+
+	bool m_RunSceneCopy = false;
+
+	struct SceneCopyResult
+	{
+		uint32_t EntityCount;
+		float PerEntityMilliseconds;
+		float BulkMilliseconds;
+	};
+	std::vector<SceneCopyResult> m_SceneCopyResults;
+
+	bool m_RunSceneSnapshot = false;
+
+	struct SceneSnapshotResult
+	{
+		const char* Name;
+		float Milliseconds;
+		size_t Bytes;
+	};
+	std::vector<SceneSnapshotResult> m_SceneSnapshotResults;
+
+	bool m_RunUUIDLookup = false;
+	float m_ScanLookupNanoseconds = 0.0f;
+	float m_UnorderedMapLookupNanoseconds = 0.0f;
+	float m_SceneLookupNanoseconds = 0.0f;
+};
@@ -74,7 +74,7 @@ void Sandbox2D::OnImGuiRender()
 	ImGui::Text("Draw Calls: %d", stats.DrawCalls);
 	ImGui::Text("Quads: %d", stats.QuadCount);
 	ImGui::Text("Vertices: %d", stats.GetTotalVertexCount());
-	ImGui::Text("Indices: %d", stats.GetTotalIndexCount());
+	ImGui::Text("Instances: %d", stats.GetTotalInstanceCount());
 
 	ImGui::ColorEdit4("Square Color", glm::value_ptr(m_SquareColor));
 
@@ -3,6 +3,7 @@
 
 #include "ExampleLayer.h"
 #include "Sandbox2D.h"
+#include "Renderer2DBenchmark.h"
 
 
 /**
@@ -16,6 +17,7 @@ public:
 	{
 		// PushLayer(new ExampleLayer());
 		PushLayer(new Sandbox2D());
+		// PushLayer(new Renderer2DBenchmark());
 	}
 
 	~Sandbox()